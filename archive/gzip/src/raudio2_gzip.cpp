@@ -1,125 +1,404 @@
 #include "raudio2_gzip.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstring>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include "raudio2/raudio2_archive.hpp"
 #include "raudio2/raudio2_common.hpp"
 #include "raudio2/raudio2_value.hpp"
+#include <thread>
 #include <vector>
 #include <zlib.h>
 
 using namespace std::literals;
 
-static int gzipUncompress(Bytef* dest, uLongf* destLen, const Bytef* source, uLong* sourceLen)
+static constexpr int64_t GZIP_WindowSize = 32768; // Deflate history size
+static constexpr int64_t GZIP_InputSize = 65536;  // Compressed bytes read at once
+static constexpr int64_t GZIP_ChunkSize = 65536;  // Uncompressed bytes inflated at once when streaming
+static constexpr int64_t GZIP_ParseSize = 1048576; // Compressed bytes read at once when listing BGZF members
+
+#ifdef RAUDIO2_STANDALONE_PLUGIN
+bool RAudio2_GetArchivePlugin(RAudio2_ArchivePlugin* plugin)
+{
+    return GZIP_MakeArchivePlugin(plugin);
+}
+#endif
+
+bool GZIP_MakeArchivePlugin(RAudio2_ArchivePlugin* plugin)
+{
+    plugin->flags = 0;
+    plugin->archiveOpen = GZIP_ArchiveOpen;
+    plugin->archiveClose = GZIP_ArchiveClose;
+    plugin->fileOpen = GZIP_FileOpen;
+    plugin->fileRead = GZIP_FileRead;
+    plugin->fileSeek = GZIP_FileSeek;
+    plugin->fileTell = GZIP_FileTell;
+    plugin->fileGetSize = GZIP_FileGetSize;
+    plugin->fileClose = GZIP_FileClose;
+    plugin->getValue = GZIP_GetValue;
+
+    return true;
+}
+
+struct GZIP_Archive {
+    RAudio2_VirtualIO* file{};
+    std::mutex fileMutex; // Guards the archive file, shared by every open file
+};
+
+static int64_t GZIP_ReadAt(GZIP_Archive* gzipArchive, void* bufferOut, int64_t offset, int64_t bytesToRead)
+{
+    std::lock_guard lock(gzipArchive->fileMutex);
+
+    ra::VirtualIO file(gzipArchive->file);
+    if (file.seek(offset) != 0)
+        return 0;
+
+    return std::max(file.read(bufferOut, bytesToRead), (int64_t)0);
+}
+
+static uint32_t GZIP_ReadLE32(const unsigned char* bytes)
 {
-    z_stream stream;
-    int err;
-    const uInt max = (uInt)-1;
-    uLong len, left;
-    Byte buf[1]; /* for detection of incomplete stream when *destLen == 0 */
-
-    len = *sourceLen;
-    if (*destLen)
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+// Inflate state at a deflate block boundary, decompression can restart from it (zran)
+struct GZIP_Checkpoint {
+    int64_t inOffset{};                // Archive file offset of the first full byte of the block
+    int bits{};                        // Bits of the previous byte that belong to the block
+    int64_t outOffset{};               // Uncompressed offset of the block
+    std::vector<unsigned char> window; // Uncompressed data before the block, used as dictionary
+};
+
+// Streaming inflate of every member of a gzip file
+struct GZIP_Stream {
+    GZIP_Archive* gzipArchive{};
+    z_stream strm{};
+    bool initialized{};
+    bool raw{};                // Restarted from a checkpoint, member trailers are skipped by hand
+    bool atEnd{};              // No more uncompressed data
+    bool recordCheckpoints{};  // Add checkpoints while inflating
+    int64_t inOffset{};        // Archive file offset of the next compressed byte read
+    int64_t outOffset{};       // Uncompressed offset of the next inflated byte
+    std::vector<unsigned char> input;
+    std::array<unsigned char, GZIP_WindowSize> history{}; // Last inflated bytes, circular
+    std::vector<GZIP_Checkpoint> checkpoints;
+
+    ~GZIP_Stream()
     {
-        left = *destLen;
-        *destLen = 0;
+        if (initialized)
+            inflateEnd(&strm);
     }
-    else
+};
+
+// Makes at least minBytes of compressed data available, if the file has them
+static bool GZIP_FillInput(GZIP_Stream& stream, uInt minBytes)
+{
+    auto& strm = stream.strm;
+    if (strm.avail_in >= minBytes)
+        return true;
+
+    if (stream.input.empty())
+        stream.input.resize((size_t)GZIP_InputSize);
+
+    if (strm.avail_in > 0)
+        std::memmove(stream.input.data(), strm.next_in, strm.avail_in);
+
+    auto bytesRead = GZIP_ReadAt(stream.gzipArchive, stream.input.data() + strm.avail_in, stream.inOffset, (int64_t)stream.input.size() - strm.avail_in);
+    stream.inOffset += bytesRead;
+
+    strm.next_in = stream.input.data();
+    strm.avail_in += (uInt)bytesRead;
+    return strm.avail_in >= minBytes;
+}
+
+// Restarts the stream at the first member
+static bool GZIP_StartStream(GZIP_Stream& stream)
+{
+    auto& strm = stream.strm;
+    if (!stream.initialized)
     {
-        left = 1;
-        dest = buf;
+        if (inflateInit2(&strm, 16 + MAX_WBITS) != Z_OK)
+            return false;
+        stream.initialized = true;
     }
+    else if (inflateReset2(&strm, 16 + MAX_WBITS) != Z_OK)
+        return false;
 
-    stream.next_in = (z_const Bytef*)source;
-    stream.avail_in = 0;
-    stream.zalloc = (alloc_func)0;
-    stream.zfree = (free_func)0;
-    stream.opaque = (voidpf)0;
+    strm.next_in = nullptr;
+    strm.avail_in = 0;
+    stream.raw = false;
+    stream.atEnd = false;
+    stream.inOffset = 0;
+    stream.outOffset = 0;
+    return true;
+}
 
-    err = inflateInit2(&stream, 16 + MAX_WBITS);
-    if (err != Z_OK)
-        return err;
+// Restarts the stream at a checkpoint
+static bool GZIP_RestoreCheckpoint(GZIP_Stream& stream, const GZIP_Checkpoint& checkpoint)
+{
+    auto& strm = stream.strm;
+    if (inflateReset2(&strm, -MAX_WBITS) != Z_OK)
+        return false;
 
-    stream.next_out = dest;
-    stream.avail_out = 0;
+    strm.next_in = nullptr;
+    strm.avail_in = 0;
 
-    do
+    if (checkpoint.bits > 0)
     {
-        if (stream.avail_out == 0)
-        {
-            stream.avail_out = left > (uLong)max ? max : (uInt)left;
-            left -= stream.avail_out;
-        }
-        if (stream.avail_in == 0)
+        unsigned char byte{};
+        if (GZIP_ReadAt(stream.gzipArchive, &byte, checkpoint.inOffset - 1, 1) != 1)
+            return false;
+        inflatePrime(&strm, checkpoint.bits, byte >> (8 - checkpoint.bits));
+    }
+    inflateSetDictionary(&strm, checkpoint.window.data(), (uInt)checkpoint.window.size());
+
+    stream.raw = true;
+    stream.atEnd = false;
+    stream.inOffset = checkpoint.inOffset;
+    stream.outOffset = checkpoint.outOffset;
+    return true;
+}
+
+static void GZIP_AddHistory(GZIP_Stream& stream, const unsigned char* data, int64_t size)
+{
+    // Only the last window of the data is kept
+    auto offset = stream.outOffset - size;
+    if (size > GZIP_WindowSize)
+    {
+        data += size - GZIP_WindowSize;
+        offset += size - GZIP_WindowSize;
+        size = GZIP_WindowSize;
+    }
+
+    while (size > 0)
+    {
+        auto historyOffset = offset % GZIP_WindowSize;
+        auto count = std::min(size, GZIP_WindowSize - historyOffset);
+        std::memcpy(stream.history.data() + historyOffset, data, (size_t)count);
+        data += count;
+        offset += count;
+        size -= count;
+    }
+}
+
+static void GZIP_AddCheckpoint(GZIP_Stream& stream)
+{
+    auto lastOffset = stream.checkpoints.empty() ? 0 : stream.checkpoints.back().outOffset;
+    if (stream.outOffset - lastOffset < RAUDIO2_GZIP_CHECKPOINT_SPAN)
+        return;
+
+    GZIP_Checkpoint checkpoint;
+    checkpoint.inOffset = stream.inOffset - stream.strm.avail_in;
+    checkpoint.bits = stream.strm.data_type & 7;
+    checkpoint.outOffset = stream.outOffset;
+
+    auto windowSize = std::min(stream.outOffset, GZIP_WindowSize);
+    checkpoint.window.resize((size_t)windowSize);
+    for (int64_t i = 0; i < windowSize; i++)
+        checkpoint.window[(size_t)i] = stream.history[(size_t)((stream.outOffset - windowSize + i) % GZIP_WindowSize)];
+
+    stream.checkpoints.push_back(std::move(checkpoint));
+}
+
+// Moves to the next gzip member after the end of a member
+static bool GZIP_NextMember(GZIP_Stream& stream)
+{
+    auto& strm = stream.strm;
+
+    // Raw inflate stops before the CRC32 and ISIZE trailer
+    if (stream.raw)
+    {
+        for (uInt skip = 8; skip > 0;)
         {
-            stream.avail_in = len > (uLong)max ? max : (uInt)len;
-            len -= stream.avail_in;
+            if (!GZIP_FillInput(stream, 1))
+                return false;
+
+            auto count = std::min(skip, strm.avail_in);
+            strm.next_in += count;
+            strm.avail_in -= count;
+            skip -= count;
         }
-        err = inflate(&stream, Z_NO_FLUSH);
-    } while (err == Z_OK);
-
-    *sourceLen -= len + stream.avail_in;
-    if (dest != buf)
-        *destLen = stream.total_out;
-    else if (stream.total_out && err == Z_BUF_ERROR)
-        left = 1;
-
-    inflateEnd(&stream);
-    return err == Z_STREAM_END
-               ? Z_OK
-           : err == Z_NEED_DICT                            ? Z_DATA_ERROR
-           : err == Z_BUF_ERROR && left + stream.avail_out ? Z_DATA_ERROR
-                                                           : err;
+    }
+
+    if (!GZIP_FillInput(stream, 2) || strm.next_in[0] != 0x1F || strm.next_in[1] != 0x8B)
+        return false;
+
+    stream.raw = false;
+    return inflateReset2(&strm, 16 + MAX_WBITS) == Z_OK;
 }
 
-static bool gzipUncompress(std::vector<unsigned char>& bytes)
+static int64_t GZIP_Inflate(GZIP_Stream& stream, unsigned char* bufferOut, int64_t bytesToInflate)
 {
-    auto uncompressedSize = 0x80000;
+    auto& strm = stream.strm;
+    int64_t bytesInflated = 0;
 
-    std::vector<unsigned char> uncompressedBytes(uncompressedSize);
-    uLongf bytesSize = (uLongf)bytes.size();
-    uLongf uncompressedBytesSize = (uLongf)uncompressedBytes.size();
-    while (true)
+    while (bytesInflated < bytesToInflate && !stream.atEnd)
     {
-        auto ret = gzipUncompress((Bytef*)uncompressedBytes.data(), &uncompressedBytesSize, (Bytef*)bytes.data(), &bytesSize);
-        if (ret == Z_OK)
+        if (strm.avail_in == 0 && !GZIP_FillInput(stream, 1))
         {
-            uncompressedBytes.resize(uncompressedBytesSize);
-            bytes = uncompressedBytes;
-            return true;
+            stream.atEnd = true;
+            break;
         }
-        else if (ret == Z_BUF_ERROR)
+
+        auto availOut = (uInt)std::min(bytesToInflate - bytesInflated, (int64_t)UINT32_MAX);
+        strm.next_out = bufferOut + bytesInflated;
+        strm.avail_out = availOut;
+
+        auto ret = inflate(&strm, stream.recordCheckpoints ? Z_BLOCK : Z_NO_FLUSH);
+
+        auto count = (int64_t)(availOut - strm.avail_out);
+        bytesInflated += count;
+        stream.outOffset += count;
+        if (stream.recordCheckpoints)
+            GZIP_AddHistory(stream, strm.next_out - count, count);
+
+        if (ret == Z_STREAM_END)
         {
-            bytesSize = (uLongf)bytes.size();
-            uncompressedBytes.resize(uncompressedBytes.size() * 2);
-            uncompressedBytesSize = (uLongf)uncompressedBytes.size();
+            stream.atEnd = !GZIP_NextMember(stream);
             continue;
         }
-        break;
+
+        if ((ret != Z_OK && ret != Z_BUF_ERROR) || (ret == Z_BUF_ERROR && strm.avail_in > 0))
+        {
+            stream.atEnd = true;
+            break;
+        }
+
+        // End of a deflate block that is not the last one
+        if (stream.recordCheckpoints && (strm.data_type & 128) && !(strm.data_type & 64))
+            GZIP_AddCheckpoint(stream);
     }
-    return false;
+    return bytesInflated;
 }
 
-#ifdef RAUDIO2_STANDALONE_PLUGIN
-bool RAudio2_GetArchivePlugin(RAudio2_ArchivePlugin* plugin)
+// BGZF members (blocked gzip, as written by bgzip) give their compressed size in the header
+struct GZIP_Member {
+    int64_t inOffset{};  // Offset of the deflate data
+    int64_t inSize{};    // Size of the deflate data
+    int64_t outOffset{}; // Uncompressed offset of the member
+    int64_t outSize{};   // Uncompressed size of the member
+};
+
+// Lists the members of a BGZF file, reading the file in large blocks
+static bool GZIP_ParseBgzfMembers(GZIP_Archive* gzipArchive, int64_t fileSize, std::vector<GZIP_Member>& membersOut, int64_t& sizeOut)
 {
-    return GZIP_MakeArchivePlugin(plugin);
+    std::vector<unsigned char> bytes;
+    int64_t bytesOffset = 0; // Archive file offset of bytes
+
+    // Bytes of the file at an offset, valid until the next call
+    auto fetch = [&](int64_t offset, int64_t size) -> const unsigned char* {
+        if (offset < bytesOffset || offset + size > bytesOffset + (int64_t)bytes.size())
+        {
+            auto count = std::min(std::max(size, GZIP_ParseSize), fileSize - offset);
+            if (count < size)
+                return nullptr;
+
+            bytes.resize((size_t)count);
+            if (GZIP_ReadAt(gzipArchive, bytes.data(), offset, count) != count)
+                return nullptr;
+            bytesOffset = offset;
+        }
+        return bytes.data() + (offset - bytesOffset);
+    };
+
+    int64_t offset = 0;
+    int64_t outOffset = 0;
+
+    while (offset < fileSize)
+    {
+        constexpr uint8_t FEXTRA = 4;
+        auto header = fetch(offset, 12);
+        if (!header || header[0] != 0x1F || header[1] != 0x8B || header[2] != 8 || header[3] != FEXTRA)
+            return false;
+
+        int64_t extraSize = header[10] | (header[11] << 8);
+        header = fetch(offset, 12 + extraSize);
+        if (!header)
+            return false;
+
+        int64_t blockSize = 0;
+        for (int64_t field = 12; field + 4 <= 12 + extraSize;)
+        {
+            int64_t fieldSize = header[field + 2] | (header[field + 3] << 8);
+            if (header[field] == 'B' && header[field + 1] == 'C' && fieldSize == 2 && field + 6 <= 12 + extraSize)
+                blockSize = (header[field + 4] | (header[field + 5] << 8)) + 1;
+            field += 4 + fieldSize;
+        }
+
+        auto dataOffset = offset + 12 + extraSize;
+        if (blockSize == 0 || offset + blockSize > fileSize || dataOffset + 8 > offset + blockSize)
+            return false;
+
+        auto trailer = fetch(offset + blockSize - 4, 4);
+        if (!trailer)
+            return false;
+
+        GZIP_Member member;
+        member.inOffset = dataOffset;
+        member.inSize = offset + blockSize - 8 - dataOffset;
+        member.outOffset = outOffset;
+        member.outSize = GZIP_ReadLE32(trailer);
+        membersOut.push_back(member);
+
+        outOffset += member.outSize;
+        offset += blockSize;
+    }
+
+    sizeOut = outOffset;
+    return !membersOut.empty();
 }
-#endif
 
-bool GZIP_MakeArchivePlugin(RAudio2_ArchivePlugin* plugin)
+// Inflates a member whose deflate data is in memory
+static bool GZIP_InflateMember(z_stream& strm, const unsigned char* bytesIn, const GZIP_Member& member, unsigned char* bytesOut)
 {
-    plugin->flags = 0;
-    plugin->archiveOpen = GZIP_ArchiveOpen;
-    plugin->archiveClose = GZIP_ArchiveClose;
-    plugin->fileOpen = GZIP_FileOpen;
-    plugin->fileRead = GZIP_FileRead;
-    plugin->fileSeek = GZIP_FileSeek;
-    plugin->fileTell = GZIP_FileTell;
-    plugin->fileGetSize = GZIP_FileGetSize;
-    plugin->fileClose = GZIP_FileClose;
-    plugin->getValue = GZIP_GetValue;
+    inflateReset(&strm);
+    strm.next_in = (Bytef*)bytesIn;
+    strm.avail_in = (uInt)member.inSize;
+    strm.next_out = bytesOut;
+    strm.avail_out = (uInt)member.outSize;
 
-    return true;
+    return inflate(&strm, Z_FINISH) == Z_STREAM_END && strm.avail_out == 0;
+}
+
+// Members are independent deflate streams, inflate them on every core
+static bool GZIP_InflateMembers(const std::vector<unsigned char>& bytes, const std::vector<GZIP_Member>& members, std::vector<unsigned char>& bytesOut)
+{
+    std::atomic<bool> failed{};
+
+    auto inflateRange = [&](size_t first, size_t last) {
+        z_stream strm{};
+        if (inflateInit2(&strm, -MAX_WBITS) != Z_OK)
+        {
+            failed = true;
+            return;
+        }
+
+        for (auto i = first; i < last && !failed; i++)
+        {
+            auto& member = members[i];
+            if (!GZIP_InflateMember(strm, bytes.data() + member.inOffset, member, bytesOut.data() + member.outOffset))
+                failed = true;
+        }
+        inflateEnd(&strm);
+    };
+
+    auto threadCount = std::clamp((size_t)std::thread::hardware_concurrency(), (size_t)1, (size_t)RAUDIO2_GZIP_MAX_THREADS);
+    threadCount = std::min(threadCount, (members.size() + 15) / 16);
+
+    std::vector<std::thread> threads;
+    auto membersPerThread = (members.size() + threadCount - 1) / threadCount;
+    for (size_t i = 1; i < threadCount; i++)
+        threads.emplace_back(inflateRange, i * membersPerThread, std::min(members.size(), (i + 1) * membersPerThread));
+
+    inflateRange(0, std::min(members.size(), membersPerThread));
+
+    for (auto& thread : threads)
+        thread.join();
+
+    return !failed;
 }
 
 bool GZIP_ArchiveOpen(RAudio2_Archive* archive_)
@@ -139,21 +418,108 @@ bool GZIP_ArchiveOpen(RAudio2_Archive* archive_)
     unsigned char fileBytes[2]{};
     file.read(fileBytes, 2);
 
-    return (fileBytes[0] == 0x1F && fileBytes[1] == 0x8B);
+    if (fileBytes[0] != 0x1F || fileBytes[1] != 0x8B)
+        return false;
+
+    auto gzipArchive = new GZIP_Archive();
+    gzipArchive->file = file.getVirtualIO();
+    archive.setCtxData(gzipArchive);
+    return true;
 }
 
 bool GZIP_ArchiveClose(RAudio2_Archive* archive)
 {
+    delete (GZIP_Archive*)archive->ctxData;
     archive->ctxData = nullptr;
     return true;
 }
 
+// BGZF member inflated on demand
+struct GZIP_CachedMember {
+    size_t index{};
+    std::vector<unsigned char> bytes;
+};
+
+// BGZF file too large to keep in memory, members are inflated as they are read
+struct GZIP_Members {
+    GZIP_Archive* gzipArchive{};
+    std::vector<GZIP_Member> members;
+    std::deque<GZIP_CachedMember> cache; // Most recently used first
+    int64_t cacheSize{};                 // Bytes of inflated members kept
+    std::vector<unsigned char> input;
+    z_stream strm{};
+    bool initialized{};
+
+    ~GZIP_Members()
+    {
+        if (initialized)
+            inflateEnd(&strm);
+    }
+};
+
 struct GZIP_File {
-    std::vector<unsigned char> fileBytes;
+    std::vector<unsigned char> fileBytes;  // Inflated file, when kept in memory
+    std::unique_ptr<GZIP_Stream> stream;   // Inflates the file as it is read otherwise
+    std::unique_ptr<GZIP_Members> members; // Inflates the members of a large BGZF file as they are read
+    std::vector<unsigned char> chunk;      // Last chunk inflated by the stream
+    int64_t chunkOffset{};                 // Uncompressed offset of chunk
+    int64_t dataSize{};
     int64_t currentOffset{};
 };
 
-bool GZIP_FileOpen(RAudio2_Archive* archive_, const char* filePath, void** fileCtxOut)
+// Inflates a file into memory, presized from the ISIZE trailer
+// NOTE: ISIZE is only a hint (the size modulo 4 GiB of the last member), files growing past the memory size fail
+static bool GZIP_InflateFile(GZIP_Archive* gzipArchive, int64_t sizeHint, std::vector<unsigned char>& bytesOut)
+{
+    constexpr int64_t maxSize = RAUDIO2_GZIP_MEMORY_SIZE;
+
+    GZIP_Stream stream;
+    stream.gzipArchive = gzipArchive;
+    if (!GZIP_StartStream(stream))
+        return false;
+
+    bytesOut.resize((size_t)std::clamp(sizeHint, GZIP_ChunkSize, maxSize + 1));
+    int64_t size = 0;
+    while (true)
+    {
+        size += GZIP_Inflate(stream, bytesOut.data() + size, (int64_t)bytesOut.size() - size);
+        if (stream.atEnd)
+            break;
+
+        if (size > maxSize)
+        {
+            bytesOut = {};
+            return false;
+        }
+        bytesOut.resize((size_t)std::min((int64_t)bytesOut.size() * 2, maxSize + 1));
+    }
+    bytesOut.resize((size_t)size);
+    bytesOut.shrink_to_fit();
+    return size > 0;
+}
+
+// Streams a file, one pass builds the checkpoint index and finds the exact size
+static std::unique_ptr<GZIP_Stream> GZIP_IndexFile(GZIP_Archive* gzipArchive, int64_t& sizeOut)
+{
+    auto stream = std::make_unique<GZIP_Stream>();
+    stream->gzipArchive = gzipArchive;
+    stream->recordCheckpoints = true;
+    if (!GZIP_StartStream(*stream))
+        return {};
+
+    std::vector<unsigned char> chunk((size_t)GZIP_ChunkSize);
+    while (GZIP_Inflate(*stream, chunk.data(), (int64_t)chunk.size()) > 0)
+    {
+    }
+
+    sizeOut = stream->outOffset;
+    stream->recordCheckpoints = false;
+    if (sizeOut <= 0 || !GZIP_StartStream(*stream))
+        return {};
+    return stream;
+}
+
+bool GZIP_FileOpen(RAudio2_Archive* archive_, const char*, void** fileCtxOut)
 {
     *fileCtxOut = nullptr;
 
@@ -161,30 +527,191 @@ bool GZIP_FileOpen(RAudio2_Archive* archive_, const char* filePath, void** fileC
     if (!archive.hasValidArchive())
         return false;
 
-    auto file = archive.getFile();
-    if (!file)
+    auto gzipArchive = (GZIP_Archive*)archive.getCtxData();
+    if (!gzipArchive)
         return false;
 
-    file.seek(0);
+    int64_t fileSize{};
+    {
+        std::lock_guard lock(gzipArchive->fileMutex);
+        fileSize = ra::VirtualIO(gzipArchive->file).getSize();
+    }
+
+    std::array<unsigned char, 18> header{};
+    std::array<unsigned char, 4> trailer{};
+    if (GZIP_ReadAt(gzipArchive, header.data(), 0, (int64_t)header.size()) < 2 || header[0] != 0x1F || header[1] != 0x8B)
+        return false;
+    GZIP_ReadAt(gzipArchive, trailer.data(), fileSize - 4, (int64_t)trailer.size());
 
     auto gzipFile = std::make_unique<GZIP_File>();
     if (!gzipFile)
         return false;
 
-    auto fileSize = file.getSize();
-    gzipFile->fileBytes.resize((size_t)fileSize);
+    // BGZF header: FEXTRA flag with a BC subfield
+    if (header[3] == 4 && header[12] == 'B' && header[13] == 'C')
+    {
+        std::vector<GZIP_Member> members;
+        int64_t dataSize{};
 
-    file.read(gzipFile->fileBytes.data(), fileSize);
+        if (GZIP_ParseBgzfMembers(gzipArchive, fileSize, members, dataSize))
+        {
+            gzipFile->dataSize = dataSize;
+
+            // Large files keep the member table only
+            if (dataSize > RAUDIO2_GZIP_MEMORY_SIZE)
+            {
+                gzipFile->members = std::make_unique<GZIP_Members>();
+                gzipFile->members->gzipArchive = gzipArchive;
+                gzipFile->members->members = std::move(members);
+
+                *fileCtxOut = gzipFile.release();
+                return true;
+            }
+
+            std::vector<unsigned char> bytes((size_t)fileSize);
+            gzipFile->fileBytes.resize((size_t)dataSize);
+            if (GZIP_ReadAt(gzipArchive, bytes.data(), 0, fileSize) != fileSize || !GZIP_InflateMembers(bytes, members, gzipFile->fileBytes))
+                return false;
 
-    if (gzipFile->fileBytes.size() > 1 && gzipFile->fileBytes[0] == 0x1F && gzipFile->fileBytes[1] == 0x8B)
-    {
-        auto success = gzipUncompress(gzipFile->fileBytes);
-        if (success)
             *fileCtxOut = gzipFile.release();
-        return success;
+            return true;
+        }
     }
 
-    return false;
+    // Files larger than the hint, or than it claims, are streamed
+    auto sizeHint = (int64_t)GZIP_ReadLE32(trailer.data());
+    if (sizeHint <= RAUDIO2_GZIP_MEMORY_SIZE && GZIP_InflateFile(gzipArchive, sizeHint, gzipFile->fileBytes))
+        gzipFile->dataSize = (int64_t)gzipFile->fileBytes.size();
+    else
+    {
+        gzipFile->stream = GZIP_IndexFile(gzipArchive, gzipFile->dataSize);
+        if (!gzipFile->stream)
+            return false;
+    }
+
+    *fileCtxOut = gzipFile.release();
+    return true;
+}
+
+// Reads from the stream, restarting from the closest checkpoint for backward or far seeks
+static int64_t GZIP_ReadStream(GZIP_File* gzipFile, unsigned char* bufferOut, int64_t position, int64_t bytesToRead)
+{
+    auto& stream = *gzipFile->stream;
+    auto& chunk = gzipFile->chunk;
+
+    int64_t bytesRead = 0;
+    while (bytesRead < bytesToRead)
+    {
+        auto readPosition = position + bytesRead;
+
+        if (readPosition >= gzipFile->chunkOffset && readPosition < gzipFile->chunkOffset + (int64_t)chunk.size())
+        {
+            auto chunkPosition = readPosition - gzipFile->chunkOffset;
+            auto count = std::min(bytesToRead - bytesRead, (int64_t)chunk.size() - chunkPosition);
+            std::memcpy(bufferOut + bytesRead, chunk.data() + chunkPosition, (size_t)count);
+            bytesRead += count;
+            continue;
+        }
+
+        auto checkpoint = std::upper_bound(stream.checkpoints.begin(), stream.checkpoints.end(), readPosition, [](int64_t offset, const GZIP_Checkpoint& checkpoint) {
+            return offset < checkpoint.outOffset;
+        });
+        bool restored = false;
+        if (checkpoint != stream.checkpoints.begin())
+        {
+            --checkpoint;
+            if (readPosition < stream.outOffset || checkpoint->outOffset > stream.outOffset)
+                restored = GZIP_RestoreCheckpoint(stream, *checkpoint);
+        }
+        if (!restored && readPosition < stream.outOffset && !GZIP_StartStream(stream))
+            break;
+
+        // Inflate up to the chunk holding the position
+        chunk.resize((size_t)GZIP_ChunkSize);
+        int64_t chunkSize = 0;
+        do
+        {
+            gzipFile->chunkOffset = stream.outOffset;
+            chunkSize = GZIP_Inflate(stream, chunk.data(), GZIP_ChunkSize);
+        } while (chunkSize > 0 && gzipFile->chunkOffset + chunkSize <= readPosition);
+
+        chunk.resize((size_t)chunkSize);
+        if (chunkSize == 0)
+            break;
+    }
+    return bytesRead;
+}
+
+// Inflated data of a member, from the cache or inflated now
+static const std::vector<unsigned char>* GZIP_GetMember(GZIP_Members& members, size_t index)
+{
+    auto cached = std::find_if(members.cache.begin(), members.cache.end(), [index](const GZIP_CachedMember& cachedMember) {
+        return cachedMember.index == index;
+    });
+    if (cached != members.cache.end())
+    {
+        if (cached != members.cache.begin())
+        {
+            auto cachedMember = std::move(*cached);
+            members.cache.erase(cached);
+            members.cache.push_front(std::move(cachedMember));
+        }
+        return &members.cache.front().bytes;
+    }
+
+    if (!members.initialized)
+    {
+        if (inflateInit2(&members.strm, -MAX_WBITS) != Z_OK)
+            return nullptr;
+        members.initialized = true;
+    }
+
+    auto& member = members.members[index];
+    members.input.resize((size_t)member.inSize);
+    if (GZIP_ReadAt(members.gzipArchive, members.input.data(), member.inOffset, member.inSize) != member.inSize)
+        return nullptr;
+
+    GZIP_CachedMember cachedMember;
+    cachedMember.index = index;
+    cachedMember.bytes.resize((size_t)member.outSize);
+    if (!GZIP_InflateMember(members.strm, members.input.data(), member, cachedMember.bytes.data()))
+        return nullptr;
+
+    // The member just inflated is always kept
+    members.cacheSize += member.outSize;
+    members.cache.push_front(std::move(cachedMember));
+    while (members.cacheSize > RAUDIO2_GZIP_MEMBER_CACHE_SIZE && members.cache.size() > 1)
+    {
+        members.cacheSize -= (int64_t)members.cache.back().bytes.size();
+        members.cache.pop_back();
+    }
+    return &members.cache.front().bytes;
+}
+
+static int64_t GZIP_ReadMembers(GZIP_Members& members, unsigned char* bufferOut, int64_t position, int64_t bytesToRead)
+{
+    int64_t bytesRead = 0;
+    while (bytesRead < bytesToRead)
+    {
+        auto readPosition = position + bytesRead;
+
+        auto member = std::upper_bound(members.members.begin(), members.members.end(), readPosition, [](int64_t offset, const GZIP_Member& member) {
+            return offset < member.outOffset;
+        });
+        if (member == members.members.begin())
+            break;
+        --member;
+
+        auto bytes = GZIP_GetMember(members, (size_t)(member - members.members.begin()));
+        auto memberPosition = readPosition - member->outOffset;
+        if (!bytes || memberPosition >= (int64_t)bytes->size())
+            break;
+
+        auto count = std::min(bytesToRead - bytesRead, (int64_t)bytes->size() - memberPosition);
+        std::memcpy(bufferOut + bytesRead, bytes->data() + memberPosition, (size_t)count);
+        bytesRead += count;
+    }
+    return bytesRead;
 }
 
 int64_t GZIP_FileRead(void* fileCtx, void* bufferOut, int64_t bytesToRead)
@@ -193,16 +720,21 @@ int64_t GZIP_FileRead(void* fileCtx, void* bufferOut, int64_t bytesToRead)
     if (!gzipFile)
         return 0;
 
-    auto dataSize = (int64_t)gzipFile->fileBytes.size();
+    auto dataSize = gzipFile->dataSize;
     int64_t endPosition = gzipFile->currentOffset + bytesToRead;
     int64_t readBytes = endPosition <= dataSize ? bytesToRead : dataSize - gzipFile->currentOffset;
 
-    if (readBytes > 0)
-    {
+    if (readBytes <= 0)
+        return 0;
+
+    if (gzipFile->stream)
+        readBytes = GZIP_ReadStream(gzipFile, (unsigned char*)bufferOut, gzipFile->currentOffset, readBytes);
+    else if (gzipFile->members)
+        readBytes = GZIP_ReadMembers(*gzipFile->members, (unsigned char*)bufferOut, gzipFile->currentOffset, readBytes);
+    else
         std::memcpy(bufferOut, gzipFile->fileBytes.data() + gzipFile->currentOffset, (size_t)readBytes);
-        gzipFile->currentOffset += readBytes;
-    }
 
+    gzipFile->currentOffset += readBytes;
     return readBytes;
 }
 
@@ -212,7 +744,7 @@ int64_t GZIP_FileSeek(void* fileCtx, int64_t offset, int whence)
     if (!gzipFile)
         return -1;
 
-    auto dataSize = (int64_t)gzipFile->fileBytes.size();
+    auto dataSize = gzipFile->dataSize;
     auto newOffset = offset;
     switch (whence)
     {
@@ -245,7 +777,7 @@ int64_t GZIP_FileGetSize(void* fileCtx)
     if (!gzipFile)
         return 0;
 
-    return (int64_t)gzipFile->fileBytes.size();
+    return gzipFile->dataSize;
 }
 
 bool GZIP_FileClose(void* fileCtx)
@@ -258,7 +790,7 @@ bool GZIP_FileClose(void* fileCtx)
     return true;
 }
 
-bool GZIP_GetValue(void* fileCtx, const char* key, int32_t keyLength, RAudio2_Value* valueOut)
+bool GZIP_GetValue(void*, const char* key, int32_t keyLength, RAudio2_Value* valueOut)
 {
     // only process keys with less than 32 chars
     auto keyHash = ra::str2int(std::string_view(key, keyLength).substr(0, 32));
@@ -272,6 +804,10 @@ bool GZIP_GetValue(void* fileCtx, const char* key, int32_t keyLength, RAudio2_Va
         return ra::MakeArrayValue(extensions, *valueOut);
         return true;
     }
+    case ra::str2int("plugin_signatures"): {
+        static const std::array<RAudio2_Signature, 2> signatures{ { { 0, 2, "\x1F\x8B" }, {} } };
+        return ra::MakeArrayValue(signatures, *valueOut);
+    }
     default: {
         switch (keyHash)
         {
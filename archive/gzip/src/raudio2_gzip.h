@@ -3,6 +3,19 @@
 #include "raudio2/raudio2_archiveplugin.hpp"
 #include "raudio2/raudio2_config.h"
 
+#ifndef RAUDIO2_GZIP_MEMORY_SIZE
+#define RAUDIO2_GZIP_MEMORY_SIZE 16777216 // Files up to this uncompressed size are inflated into memory, larger ones are streamed (16 MiB)
+#endif
+#ifndef RAUDIO2_GZIP_CHECKPOINT_SPAN
+#define RAUDIO2_GZIP_CHECKPOINT_SPAN 1048576 // Uncompressed distance between seek checkpoints of streamed files
+#endif
+#ifndef RAUDIO2_GZIP_MEMBER_CACHE_SIZE
+#define RAUDIO2_GZIP_MEMBER_CACHE_SIZE 1048576 // Inflated members kept for BGZF files too large for memory
+#endif
+#ifndef RAUDIO2_GZIP_MAX_THREADS
+#define RAUDIO2_GZIP_MAX_THREADS 8 // Maximum threads inflating BGZF members
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
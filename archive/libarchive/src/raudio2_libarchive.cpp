@@ -1,11 +1,20 @@
 #include "raudio2_libarchive.h"
+#include <algorithm>
 #include <archive.h>
 #include <archive_entry.h>
+#include <array>
+#include <atomic>
 #include <cstring>
+#include <deque>
+#include <list>
+#include <map>
 #include <memory>
+#include <mutex>
 #include "raudio2/raudio2_archive.hpp"
 #include "raudio2/raudio2_common.hpp"
 #include "raudio2/raudio2_value.hpp"
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 using namespace std::literals;
@@ -33,11 +42,84 @@ bool LIBARCHIVE_MakeArchivePlugin(RAudio2_ArchivePlugin* plugin)
     return true;
 }
 
-struct LIBARCHIVE_Archive {
+// Maximum number of archive indexes kept in memory
+static constexpr size_t LIBARCHIVE_MaxIndexCount = 64;
+
+struct LIBARCHIVE_IndexEntry {
+    int64_t ordinal{};          // Position of the entry in the archive
+    int64_t size{ -1 };         // Uncompressed size (-1 if unknown)
+    int64_t headerOffset{ -1 }; // Offset of the entry header in the archive file (-1 if unknown)
+    int64_t dataOffset{ -1 };   // Offset of a stored entry in the archive file (-1 if compressed or unknown)
+};
+
+// Entries of an archive, filled while walking it
+struct LIBARCHIVE_Index {
+    std::unordered_map<std::string, LIBARCHIVE_IndexEntry> entries;
+    int64_t entryCount{}; // Number of entries walked
+    bool complete{};      // All entries have been walked
+    std::mutex mutex;     // Indexes are shared by every open instance of an archive
+};
+
+// Indexes of recently opened archives, by archive fingerprint
+struct LIBARCHIVE_IndexCache {
+    std::unordered_map<uint64_t, std::shared_ptr<LIBARCHIVE_Index>> indexes;
+    std::list<uint64_t> lru; // Most recently used first
+    std::mutex mutex;
+};
+
+static LIBARCHIVE_IndexCache indexCache;
+
+using LIBARCHIVE_EntryData = std::vector<unsigned char>;
+using LIBARCHIVE_ArchiveKey = std::array<uint64_t, 6>;                     // File identity, or handle number without one
+using LIBARCHIVE_EntryKey = std::pair<LIBARCHIVE_ArchiveKey, std::string>; // Archive key and entry path
+
+// Decompressed entries of solid archives, kept while walking to other entries
+// NOTE: Least recently used entries are dropped when the budget is exceeded
+struct LIBARCHIVE_EntryCache {
+    struct Entry {
+        std::shared_ptr<const LIBARCHIVE_EntryData> data;
+        std::list<LIBARCHIVE_EntryKey>::iterator lruPosition;
+    };
+
+    std::map<LIBARCHIVE_EntryKey, Entry> entries;
+    std::list<LIBARCHIVE_EntryKey> lru; // Most recently used first
+    int64_t size{};                     // Bytes of cached data
+    std::mutex mutex;
+};
+
+static LIBARCHIVE_EntryCache entryCache;
+
+// libarchive reader over the archive file
+// NOTE: Every reader keeps its own offset, the archive file is shared by all readers and stored entries
+struct LIBARCHIVE_Reader {
     archive* archive_{};
-    archive_entry* firstEntry{};
+    archive_entry* currentEntry{};     // Header of the entry the reader is positioned at
+    int64_t currentOrdinal{};          // Position of currentEntry in the archive
+    int64_t currentHeaderOffset{ -1 }; // Offset of the header of currentEntry in the archive file (-1 if unknown)
+    bool currentEntryRead{};           // Data of currentEntry has been (partially) read
+    bool atEnd{};                      // All entries have been walked
+    int headerFormat{};                // Format of archives whose entries are read starting at their header (tar or zip, 0 if none)
+    RAudio2_VirtualIO* file{};
+    std::mutex* fileMutex{};
+    int64_t baseOffset{}; // Offset of the archive file the reader started at
+    int64_t readOffset{}; // Offset of the reader in the archive file
     std::vector<unsigned char> buffer;
-    int64_t currentOffset{};
+
+    ~LIBARCHIVE_Reader()
+    {
+        if (archive_)
+            archive_read_free(archive_);
+    }
+};
+
+struct LIBARCHIVE_Archive {
+    LIBARCHIVE_Reader reader; // Walks the archive to open entries
+    std::shared_ptr<LIBARCHIVE_Index> index;
+    uint64_t fingerprint{};
+    LIBARCHIVE_ArchiveKey archiveKey{}; // Key of the cached entries of solid archives
+    bool solid{};                       // Reaching an entry decompresses every entry before it
+    std::mutex mutex;                   // Guards the reader
+    std::mutex fileMutex;               // Guards the archive file
 };
 
 static int LIBARCHIVE_OnNull(struct archive* archive_, void* userData)
@@ -50,23 +132,50 @@ static la_ssize_t LIBARCHIVE_OnRead(struct archive* archive_, void* archiveCtx,
 {
     *bufferOut = nullptr;
 
-    auto raudioArchive = (RAudio2_Archive*)archiveCtx;
-    if (!raudioArchive)
+    auto reader = (LIBARCHIVE_Reader*)archiveCtx;
+    if (!reader)
         return 0;
 
-    auto libArchive = (LIBARCHIVE_Archive*)raudioArchive->ctxData;
-    if (!libArchive)
-        return 0;
+    // Memory backed files are handed to libarchive directly, no copy or lock needed
+    // The rest of the file is returned at once so libarchive never joins blocks either
+    ra::VirtualIO file(reader->file);
+    if (file.hasValidGetBuffer())
+    {
+        int64_t fileSize{};
+        auto fileData = (const unsigned char*)file.getBuffer(fileSize);
+        if (fileData)
+        {
+            if (reader->readOffset >= fileSize)
+                return 0;
 
-    if (libArchive->buffer.size() < 0x80000)
+            auto bytesRead = fileSize - reader->readOffset;
+            *bufferOut = fileData + reader->readOffset;
+            reader->readOffset += bytesRead;
+            return bytesRead;
+        }
+    }
+
+    if (reader->buffer.size() < 0x80000)
     {
-        libArchive->buffer.resize(0x80000);
+        reader->buffer.resize(0x80000);
     }
-    *bufferOut = libArchive->buffer.data();
+    *bufferOut = reader->buffer.data();
+
+    // Readers started at an entry header only need the header to check the entry
+    auto readSize = (int64_t)reader->buffer.size();
+    if (reader->baseOffset > 0 && reader->readOffset == reader->baseOffset)
+        readSize = 0x2000;
+
+    std::lock_guard lock(*reader->fileMutex);
+
+    if (file.seek(reader->readOffset) != 0)
+        return ARCHIVE_FATAL;
 
-    ra::VirtualIO file = raudioArchive->file;
+    auto bytesRead = file.read(reader->buffer.data(), readSize);
+    if (bytesRead > 0)
+        reader->readOffset += bytesRead;
 
-    return file.read(libArchive->buffer.data(), (int64_t)libArchive->buffer.size());
+    return bytesRead;
 }
 
 // Seeks to specified location in the file and returns the position.
@@ -74,18 +183,34 @@ static la_ssize_t LIBARCHIVE_OnRead(struct archive* archive_, void* archiveCtx,
 // Return ARCHIVE_FATAL if the seek fails for any reason.
 static la_int64_t LIBARCHIVE_OnSeek(struct archive* archive_, void* archiveCtx, la_int64_t offset, int whence)
 {
-    auto raudioArchive = (RAudio2_Archive*)archiveCtx;
-    if (!raudioArchive)
+    auto reader = (LIBARCHIVE_Reader*)archiveCtx;
+    if (!reader)
         return ARCHIVE_FATAL;
 
-    ra::VirtualIO file(raudioArchive->file);
+    std::lock_guard lock(*reader->fileMutex);
+
+    ra::VirtualIO file(reader->file);
     if (!file)
         return ARCHIVE_FATAL;
 
-    if (file.seek(offset, whence) == 0)
-        return file.tell();
+    auto newOffset = (int64_t)offset;
+    switch (whence)
+    {
+    case SEEK_CUR:
+        newOffset += reader->readOffset;
+        break;
+    case SEEK_END:
+        newOffset += file.getSize();
+        break;
+    default:
+        break;
+    }
+
+    if (newOffset < 0)
+        return ARCHIVE_FATAL;
 
-    return ARCHIVE_FATAL;
+    reader->readOffset = newOffset;
+    return newOffset;
 }
 
 // Skips at most request bytes from archive and returns the skipped amount.
@@ -94,17 +219,359 @@ static la_int64_t LIBARCHIVE_OnSeek(struct archive* archive_, void* archiveCtx,
 // read callback and discard data as necessary to make up the full skip.
 static la_int64_t LIBARCHIVE_OnSkip(struct archive* archive_, void* archiveCtx, la_int64_t skipBytes)
 {
-    auto raudioArchive = (RAudio2_Archive*)archiveCtx;
-    if (!raudioArchive)
+    auto reader = (LIBARCHIVE_Reader*)archiveCtx;
+    if (!reader)
         return 0;
 
-    ra::VirtualIO file(raudioArchive->file);
+    std::lock_guard lock(*reader->fileMutex);
+
+    ra::VirtualIO file(reader->file);
     if (!file)
         return 0;
 
-    auto currPos = file.tell();
-    file.seek(skipBytes, RAUDIO2_SEEK_CUR);
-    return file.tell() - currPos;
+    auto skipped = std::clamp((int64_t)skipBytes, (int64_t)0, file.getSize() - reader->readOffset);
+    reader->readOffset += skipped;
+    return skipped;
+}
+
+// Identifies an archive by its size and the bytes at its start and end
+// NOTE: Archives can share a fingerprint, indexed entries are checked against the headers read
+static uint64_t LIBARCHIVE_Fingerprint(ra::VirtualIO file)
+{
+    uint64_t hash = 14695981039346656037ull;
+    auto hashBytes = [&hash](const unsigned char* data, int64_t size) {
+        for (int64_t i = 0; i < size; i++)
+        {
+            hash ^= data[i];
+            hash *= 1099511628211ull;
+        }
+    };
+
+    auto fileSize = file.getSize();
+    hashBytes((const unsigned char*)&fileSize, sizeof(fileSize));
+
+    std::array<unsigned char, 4096> data{};
+    if (file.seek(0) == 0)
+        hashBytes(data.data(), std::max(file.read(data.data(), (int64_t)data.size()), (int64_t)0));
+    if (fileSize > (int64_t)data.size() && file.seek(fileSize - (int64_t)data.size()) == 0)
+        hashBytes(data.data(), std::max(file.read(data.data(), (int64_t)data.size()), (int64_t)0));
+
+    return hash;
+}
+
+// Identifies the archive file of the cached entries of solid archives, which are used without reading any header.
+// Files on disk are identified by device, inode, change times and size, others only by the open archive handle
+static LIBARCHIVE_ArchiveKey LIBARCHIVE_GetArchiveKey(ra::VirtualIO file)
+{
+    static std::atomic<uint64_t> handleCounter{ 0 };
+
+    RAudio2_FileIdentity identity{};
+    if (file.getIdentity(identity))
+        return { identity.device, identity.index, (uint64_t)identity.modifiedTime, (uint64_t)identity.changedTime, (uint64_t)identity.size, 0 };
+
+    return { 0, 0, 0, 0, 0, ++handleCounter };
+}
+
+static std::shared_ptr<LIBARCHIVE_Index> LIBARCHIVE_GetIndex(uint64_t fingerprint)
+{
+    std::lock_guard lock(indexCache.mutex);
+
+    auto it = indexCache.indexes.find(fingerprint);
+    if (it != indexCache.indexes.end())
+    {
+        indexCache.lru.remove(fingerprint);
+        indexCache.lru.push_front(fingerprint);
+        return it->second;
+    }
+
+    auto index = std::make_shared<LIBARCHIVE_Index>();
+    indexCache.indexes.emplace(fingerprint, index);
+    indexCache.lru.push_front(fingerprint);
+
+    if (indexCache.lru.size() > LIBARCHIVE_MaxIndexCount)
+    {
+        indexCache.indexes.erase(indexCache.lru.back());
+        indexCache.lru.pop_back();
+    }
+    return index;
+}
+
+static std::shared_ptr<const LIBARCHIVE_EntryData> LIBARCHIVE_FindCachedEntry(const LIBARCHIVE_ArchiveKey& archiveKey, const std::string_view path)
+{
+    std::lock_guard lock(entryCache.mutex);
+
+    auto it = entryCache.entries.find({ archiveKey, std::string(path) });
+    if (it == entryCache.entries.end())
+        return {};
+
+    entryCache.lru.splice(entryCache.lru.begin(), entryCache.lru, it->second.lruPosition);
+    return it->second.data;
+}
+
+static void LIBARCHIVE_CacheEntry(const LIBARCHIVE_ArchiveKey& archiveKey, const std::string_view path, std::shared_ptr<const LIBARCHIVE_EntryData> data)
+{
+    std::lock_guard lock(entryCache.mutex);
+
+    LIBARCHIVE_EntryKey key{ archiveKey, std::string(path) };
+    if (entryCache.entries.find(key) != entryCache.entries.end())
+        return;
+
+    entryCache.lru.push_front(key);
+    entryCache.size += (int64_t)data->size();
+    entryCache.entries.emplace(std::move(key), LIBARCHIVE_EntryCache::Entry{ std::move(data), entryCache.lru.begin() });
+
+    // Entries still read by files stay alive through their shared_ptr
+    while (entryCache.size > RAUDIO2_LIBARCHIVE_ENTRY_CACHE_BUDGET && !entryCache.lru.empty())
+    {
+        auto it = entryCache.entries.find(entryCache.lru.back());
+        entryCache.size -= (int64_t)it->second.data->size();
+        entryCache.entries.erase(it);
+        entryCache.lru.pop_back();
+    }
+}
+
+// Drops the cached entries of an archive, entries still read by files stay alive through their shared_ptr
+static void LIBARCHIVE_DropCachedEntries(const LIBARCHIVE_ArchiveKey& archiveKey)
+{
+    std::lock_guard lock(entryCache.mutex);
+
+    auto it = entryCache.entries.lower_bound({ archiveKey, std::string() });
+    while (it != entryCache.entries.end() && it->first.first == archiveKey)
+    {
+        entryCache.size -= (int64_t)it->second.data->size();
+        entryCache.lru.erase(it->second.lruPosition);
+        it = entryCache.entries.erase(it);
+    }
+}
+
+// Solid archives (7z, RAR and compressed tarballs) decompress everything up to an entry to reach it
+static bool LIBARCHIVE_IsSolid(archive* archive_)
+{
+    if (archive_filter_code(archive_, 0) != ARCHIVE_FILTER_NONE)
+        return true;
+
+    switch (archive_format(archive_) & ARCHIVE_FORMAT_BASE_MASK)
+    {
+    case ARCHIVE_FORMAT_7ZIP:
+    case ARCHIVE_FORMAT_RAR:
+    case ARCHIVE_FORMAT_RAR_V5:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Entries of uncompressed tar and zip archives are self contained, a reader can start at any entry header
+static int LIBARCHIVE_HeaderFormat(archive* archive_)
+{
+    if (archive_filter_code(archive_, 0) != ARCHIVE_FILTER_NONE)
+        return 0;
+
+    auto format = archive_format(archive_) & ARCHIVE_FORMAT_BASE_MASK;
+    return format == ARCHIVE_FORMAT_TAR || format == ARCHIVE_FORMAT_ZIP ? format : 0;
+}
+
+// Copies the data blocks of the current entry, starting with an already read block
+static int LIBARCHIVE_ReadEntryData(archive* archive_, LIBARCHIVE_EntryData& data, int r, const void* buff, size_t size, la_int64_t offset)
+{
+    while (r == ARCHIVE_OK)
+    {
+        auto endOffset = (size_t)offset + size;
+        if (data.size() < endOffset)
+            data.resize(endOffset);
+
+        std::memcpy(data.data() + offset, buff, size);
+        r = archive_read_data_block(archive_, &buff, &size, &offset);
+    }
+    return r;
+}
+
+// Keeps the current entry of a solid archive before the reader moves past it
+static void LIBARCHIVE_CacheCurrentEntry(LIBARCHIVE_Archive* libArchive)
+{
+    auto& reader = libArchive->reader;
+    auto entry = reader.currentEntry;
+    if (!libArchive->solid || reader.currentEntryRead || archive_entry_filetype(entry) != AE_IFREG)
+        return;
+    if (!archive_entry_size_is_set(entry) || archive_entry_size(entry) > RAUDIO2_LIBARCHIVE_ENTRY_CACHE_BUDGET / 4)
+        return;
+
+    auto pathName = archive_entry_pathname_utf8(entry);
+    if (!pathName || LIBARCHIVE_FindCachedEntry(libArchive->archiveKey, pathName))
+        return;
+
+    auto data = std::make_shared<LIBARCHIVE_EntryData>();
+    data->reserve((size_t)archive_entry_size(entry));
+
+    const void* buff{};
+    size_t size{};
+    la_int64_t offset{};
+    int r = archive_read_data_block(reader.archive_, &buff, &size, &offset);
+    reader.currentEntryRead = true;
+
+    if (LIBARCHIVE_ReadEntryData(reader.archive_, *data, r, buff, size, offset) == ARCHIVE_EOF)
+        LIBARCHIVE_CacheEntry(libArchive->archiveKey, pathName, std::move(data));
+}
+
+// (Re)opens a reader at the first entry, or at the header of an entry of a tar or zip archive
+// NOTE: Zip entries are then read from their local header, without the central directory
+static bool LIBARCHIVE_OpenReader(LIBARCHIVE_Reader* reader, int64_t headerOffset, int64_t ordinal)
+{
+    if (reader->archive_)
+        archive_read_free(reader->archive_);
+
+    reader->archive_ = nullptr;
+    reader->currentEntry = nullptr;
+    reader->currentOrdinal = ordinal;
+    reader->currentHeaderOffset = headerOffset;
+    reader->currentEntryRead = false;
+    reader->atEnd = false;
+    reader->baseOffset = headerOffset;
+    reader->readOffset = headerOffset;
+
+    auto archiveCtx = archive_read_new();
+    if (!archiveCtx)
+        return false;
+
+    archive_read_set_callback_data(archiveCtx, reader);
+    archive_read_set_open_callback(archiveCtx, LIBARCHIVE_OnNull);
+    archive_read_set_read_callback(archiveCtx, LIBARCHIVE_OnRead);
+    archive_read_set_skip_callback(archiveCtx, LIBARCHIVE_OnSkip);
+
+    if (headerOffset == 0)
+    {
+        archive_read_support_filter_all(archiveCtx);
+        archive_read_support_format_all(archiveCtx);
+        archive_read_support_format_raw(archiveCtx);
+        archive_read_set_seek_callback(archiveCtx, LIBARCHIVE_OnSeek);
+    }
+    else if (reader->headerFormat == ARCHIVE_FORMAT_TAR)
+        archive_read_support_format_tar(archiveCtx);
+    else
+        archive_read_support_format_zip_streamable(archiveCtx);
+    archive_read_set_close_callback(archiveCtx, LIBARCHIVE_OnNull);
+
+    if (archive_read_open1(archiveCtx) != ARCHIVE_OK ||
+        archive_read_next_header(archiveCtx, &reader->currentEntry) != ARCHIVE_OK)
+    {
+        archive_read_free(archiveCtx);
+        reader->currentEntry = nullptr;
+        return false;
+    }
+
+    reader->archive_ = archiveCtx;
+    return true;
+}
+
+// Moves a reader to the next entry
+static bool LIBARCHIVE_NextEntry(LIBARCHIVE_Reader* reader)
+{
+    // Tar headers follow the data of the previous entry, once it is skipped
+    reader->currentHeaderOffset = -1;
+    if (reader->headerFormat == ARCHIVE_FORMAT_TAR && archive_read_data_skip(reader->archive_) == ARCHIVE_OK)
+        reader->currentHeaderOffset = reader->baseOffset + (int64_t)archive_filter_bytes(reader->archive_, 0);
+
+    auto ret = archive_read_next_header(reader->archive_, &reader->currentEntry);
+    if (ret != ARCHIVE_OK && ret != ARCHIVE_WARN)
+    {
+        reader->atEnd = ret == ARCHIVE_EOF;
+        return false;
+    }
+
+    reader->currentOrdinal++;
+    reader->currentEntryRead = false;
+    return true;
+}
+
+// Offset of the local header of the current zip entry, found backwards from the entry data
+// NOTE: Seekable zip readers jump between local headers through the central directory, the consumed bytes stop at the entry data
+static int64_t LIBARCHIVE_ZipHeaderOffset(LIBARCHIVE_Reader* reader)
+{
+    constexpr int64_t localHeaderSize = 30;
+    auto dataOffset = reader->baseOffset + (int64_t)archive_filter_bytes(reader->archive_, 0);
+
+    std::lock_guard lock(*reader->fileMutex);
+
+    ra::VirtualIO file(reader->file);
+
+    // Entry paths and extra fields are short, look close to the data first
+    for (int64_t windowSize : { (int64_t)256, localHeaderSize + 0xFFFF + 0xFFFF })
+    {
+        auto windowOffset = std::max(dataOffset - windowSize, (int64_t)0);
+        std::vector<unsigned char> window((size_t)(dataOffset - windowOffset));
+        if ((int64_t)window.size() < localHeaderSize || file.seek(windowOffset) != 0 ||
+            file.read(window.data(), (int64_t)window.size()) != (int64_t)window.size())
+            return -1;
+
+        for (auto i = (int64_t)window.size() - localHeaderSize; i >= 0; i--)
+        {
+            auto header = window.data() + i;
+            if (std::memcmp(header, "PK\x03\x04", 4) != 0)
+                continue;
+
+            auto pathSize = (int64_t)(header[26] | header[27] << 8);
+            auto extraSize = (int64_t)(header[28] | header[29] << 8);
+            if (windowOffset + i + localHeaderSize + pathSize + extraSize == dataOffset)
+                return windowOffset + i;
+        }
+        if (windowOffset == 0)
+            break;
+    }
+    return -1;
+}
+
+// Forgets the entries of an index that doesn't match the archive
+static void LIBARCHIVE_DropIndex(LIBARCHIVE_Index& index)
+{
+    index.entries.clear();
+    index.entryCount = 0;
+    index.complete = false;
+}
+
+// Adds the current entry to the index, returns false if the index disagrees with its header
+// NOTE: Entries before entryCount are all indexed, a path seen again later is a duplicate entry
+static bool LIBARCHIVE_IndexCurrentEntry(LIBARCHIVE_Archive* libArchive)
+{
+    auto& index = *libArchive->index;
+    auto& reader = libArchive->reader;
+    auto entry = reader.currentEntry;
+
+    auto pathName = archive_entry_pathname_utf8(entry);
+    if (!pathName)
+        pathName = archive_entry_pathname(entry);
+    if (!pathName)
+        return true;
+
+    auto size = archive_entry_size_is_set(entry) ? (int64_t)archive_entry_size(entry) : -1;
+
+    auto [it, inserted] = index.entries.try_emplace(pathName);
+    if (inserted)
+    {
+        if (reader.currentOrdinal < index.entryCount)
+            return false;
+
+        it->second.ordinal = reader.currentOrdinal;
+        it->second.size = size;
+    }
+    else if (it->second.ordinal > reader.currentOrdinal)
+        return false;
+    else if (it->second.ordinal == reader.currentOrdinal && it->second.size >= 0 && size >= 0 && it->second.size != size)
+        return false;
+
+    if (it->second.ordinal == reader.currentOrdinal)
+    {
+        if (reader.headerFormat == ARCHIVE_FORMAT_TAR)
+        {
+            if (it->second.headerOffset >= 0 && reader.currentHeaderOffset >= 0 && it->second.headerOffset != reader.currentHeaderOffset)
+                return false;
+            if (it->second.headerOffset < 0)
+                it->second.headerOffset = reader.currentHeaderOffset;
+        }
+        else if (reader.headerFormat == ARCHIVE_FORMAT_ZIP && it->second.headerOffset < 0)
+            it->second.headerOffset = LIBARCHIVE_ZipHeaderOffset(&reader);
+    }
+    index.entryCount = std::max(index.entryCount, reader.currentOrdinal + 1);
+    return true;
 }
 
 bool LIBARCHIVE_ArchiveOpen(RAudio2_Archive* archive_)
@@ -119,46 +586,39 @@ bool LIBARCHIVE_ArchiveOpen(RAudio2_Archive* archive_)
     if (!file)
         return false;
 
-    file.seek(0);
-
     auto archiveStruct = std::make_unique<LIBARCHIVE_Archive>();
     if (!archiveStruct)
         return false;
 
-    auto archiveCtx = archive_read_new();
-    archiveStruct->archive_ = archiveCtx;
-    raudioArchive.setCtxData(archiveStruct.get());
-
-    archive_read_support_filter_all(archiveCtx);
-    archive_read_support_format_all(archiveCtx);
-    archive_read_support_format_raw(archiveCtx);
-
-    archive_read_set_callback_data(archiveCtx, archive_);
-    archive_read_set_open_callback(archiveCtx, LIBARCHIVE_OnNull);
-    archive_read_set_read_callback(archiveCtx, LIBARCHIVE_OnRead);
-    archive_read_set_seek_callback(archiveCtx, LIBARCHIVE_OnSeek);
-    archive_read_set_skip_callback(archiveCtx, LIBARCHIVE_OnSkip);
-    archive_read_set_close_callback(archiveCtx, LIBARCHIVE_OnNull);
-
-    auto ret = archive_read_open1(archiveCtx);
-    if (ret != ARCHIVE_OK)
-        return false;
+    archiveStruct->reader.file = file.getVirtualIO();
+    archiveStruct->reader.fileMutex = &archiveStruct->fileMutex;
 
-    ret = archive_read_next_header(archiveCtx, &archiveStruct->firstEntry);
-    if (ret != ARCHIVE_OK)
+    if (!LIBARCHIVE_OpenReader(&archiveStruct->reader, 0, 0))
     {
-        archive_read_free(archiveCtx);
         return false;
     }
 
-    auto archiveFormat = archive_format(archiveCtx);
-    auto archiveFilter = archive_filter_code(archiveCtx, 0);
+    auto archiveFormat = archive_format(archiveStruct->reader.archive_);
+    auto archiveFilter = archive_filter_code(archiveStruct->reader.archive_, 0);
     if (archiveFormat == ARCHIVE_FORMAT_RAW && archiveFilter == ARCHIVE_FILTER_NONE)
     {
-        archive_read_free(archiveCtx);
         return false;
     }
 
+    archiveStruct->fingerprint = LIBARCHIVE_Fingerprint(file);
+    archiveStruct->index = LIBARCHIVE_GetIndex(archiveStruct->fingerprint);
+    archiveStruct->solid = LIBARCHIVE_IsSolid(archiveStruct->reader.archive_);
+    archiveStruct->archiveKey = LIBARCHIVE_GetArchiveKey(file);
+    archiveStruct->reader.headerFormat = LIBARCHIVE_HeaderFormat(archiveStruct->reader.archive_);
+    {
+        std::lock_guard indexLock(archiveStruct->index->mutex);
+        if (!LIBARCHIVE_IndexCurrentEntry(archiveStruct.get()))
+        {
+            LIBARCHIVE_DropIndex(*archiveStruct->index);
+            LIBARCHIVE_IndexCurrentEntry(archiveStruct.get());
+        }
+    }
+
     raudioArchive.setCtxData(archiveStruct.release());
 
     return true;
@@ -174,17 +634,258 @@ bool LIBARCHIVE_ArchiveClose(RAudio2_Archive* archive_)
     if (!libArchive)
         return false;
 
-    archive_read_free(libArchive->archive_);
+    // Entries of archives without an identity can't be found again once the handle is closed
+    if (libArchive->archiveKey[5] != 0)
+        LIBARCHIVE_DropCachedEntries(libArchive->archiveKey);
+
     delete libArchive;
     raudioArchive.setCtxData(nullptr);
     return true;
 }
 
+// Compressed entry decompressed on demand by its own reader
+// NOTE: libarchive can't save decompressor state, backward seeks past the kept data restart from the entry start
+struct LIBARCHIVE_LazyEntry {
+    LIBARCHIVE_Reader reader;
+    int64_t ordinal{};                                     // Position of the entry in the archive
+    int64_t headerOffset{ -1 };                            // Offset of the entry header in the archive file (-1 if unknown)
+    std::string pathName;                                  // Path of the entry, checked when the reader restarts
+    int64_t decodedOffset{};                               // Offset of the reader in the entry
+    std::vector<unsigned char> head;                       // Start of the entry, kept for header probes
+    std::deque<std::vector<unsigned char>> window;         // Most recently decompressed chunks
+    int64_t windowOffset{};                                // Offset of the first window chunk in the entry
+};
+
 struct LIBARCHIVE_File {
-    std::vector<unsigned char> fileBytes;
+    LIBARCHIVE_Archive* libArchive{};                      // Archive, stored entries are read from its file directly
+    int64_t dataOffset{ -1 };                              // Offset of a stored entry in the archive file (-1 if extracted)
+    int64_t dataSize{};                                    // Size of the entry
+    std::shared_ptr<const LIBARCHIVE_EntryData> fileBytes; // Extracted entry
+    std::unique_ptr<LIBARCHIVE_LazyEntry> lazyEntry;       // Entry decompressed on demand
     int64_t currentOffset{};
 };
 
+// Checks if the first data block of an entry is found as is in the archive file at the current read position
+// NOTE: Only stored (uncompressed) entries of unfiltered archives match, compressed data never does
+static bool LIBARCHIVE_IsStoredEntry(LIBARCHIVE_Archive* libArchive, const void* block, size_t blockSize, int64_t blockOffset, int64_t& dataOffsetOut)
+{
+    auto archive_ = libArchive->reader.archive_;
+    auto entry = libArchive->reader.currentEntry;
+
+    if (archive_filter_code(archive_, 0) != ARCHIVE_FILTER_NONE)
+        return false;
+    if (!archive_entry_size_is_set(entry) || archive_entry_is_encrypted(entry) || archive_entry_sparse_count(entry) > 0)
+        return false;
+    if (blockOffset != 0 || blockSize == 0)
+        return false;
+
+    std::lock_guard lock(libArchive->fileMutex);
+
+    ra::VirtualIO file(libArchive->reader.file);
+
+    // Bytes consumed by the format reader, the entry data starts right after its header
+    auto dataOffset = libArchive->reader.baseOffset + (int64_t)archive_filter_bytes(archive_, 0);
+    auto dataSize = (int64_t)archive_entry_size(entry);
+    if (dataOffset <= 0 || dataOffset + dataSize > file.getSize())
+        return false;
+
+    auto compareSize = std::min(blockSize, (size_t)0x10000);
+    std::vector<unsigned char> fileData(compareSize);
+
+    bool match = file.seek(dataOffset) == 0 &&
+                 file.read(fileData.data(), (int64_t)compareSize) == (int64_t)compareSize &&
+                 std::memcmp(fileData.data(), block, compareSize) == 0;
+
+    if (match)
+        dataOffsetOut = dataOffset;
+    return match;
+}
+
+// Opens a reader at the header of an indexed entry, the entry read there must be the indexed one
+static bool LIBARCHIVE_OpenReaderAtEntry(LIBARCHIVE_Reader* reader, const std::string_view pathName, int64_t ordinal, int64_t headerOffset)
+{
+    if (reader->headerFormat == 0 || headerOffset <= 0 || !LIBARCHIVE_OpenReader(reader, headerOffset, ordinal))
+        return false;
+
+    auto currentPathName = archive_entry_pathname_utf8(reader->currentEntry);
+    return currentPathName && currentPathName == pathName;
+}
+
+// Positions the reader at an entry, walking the archive from the closest position
+// NOTE: An empty path opens the first entry, raw archives (single compressed file) have a single "data" entry
+static bool LIBARCHIVE_FindEntry(LIBARCHIVE_Archive* libArchive, const std::string_view filePath)
+{
+    auto& index = *libArchive->index;
+    auto& reader = libArchive->reader;
+
+    auto isTarget = [&]() {
+        if (filePath.empty())
+            return reader.currentOrdinal == 0;
+
+        auto pathName = archive_entry_pathname_utf8(reader.currentEntry);
+        return pathName && (pathName == filePath || pathName == "data"sv);
+    };
+
+    // Known entries tell where to start walking from
+    int64_t targetOrdinal = -1;
+    int64_t targetHeaderOffset = -1;
+    if (filePath.empty())
+        targetOrdinal = 0;
+    else
+    {
+        auto it = index.entries.find(std::string(filePath));
+        if (it == index.entries.end())
+            it = index.entries.find("data");
+        if (it != index.entries.end())
+        {
+            targetOrdinal = it->second.ordinal;
+            targetHeaderOffset = it->second.headerOffset;
+        }
+        else if (index.complete)
+            return false;
+    }
+
+    // The reader only moves forward, restart it if the entry is behind or already read
+    // NOTE: Unknown entries are past the indexed ones, walking forward always reaches them
+    bool restart = !reader.archive_ ||
+                   (targetOrdinal >= 0 && targetOrdinal < reader.currentOrdinal) ||
+                   (targetOrdinal == reader.currentOrdinal && reader.currentEntryRead);
+
+    // Indexed entries of tar and zip archives are read from their header, a failed attempt leaves the reader elsewhere
+    bool atTarget = !restart && targetOrdinal == reader.currentOrdinal;
+    if (!atTarget && reader.headerFormat != 0 && targetHeaderOffset > 0)
+        restart = !LIBARCHIVE_OpenReaderAtEntry(&reader, filePath, targetOrdinal, targetHeaderOffset);
+
+    if (restart && !LIBARCHIVE_OpenReader(&reader, 0, 0))
+        return false;
+
+    while (true)
+    {
+        // The index came from another archive with the same fingerprint, walk this one from the start
+        if (!LIBARCHIVE_IndexCurrentEntry(libArchive))
+        {
+            LIBARCHIVE_DropIndex(index);
+            if (!LIBARCHIVE_OpenReader(&reader, 0, 0))
+                return false;
+
+            targetOrdinal = filePath.empty() ? 0 : -1;
+            continue;
+        }
+
+        if ((targetOrdinal < 0 || targetOrdinal == reader.currentOrdinal) && isTarget())
+            return true;
+
+        LIBARCHIVE_CacheCurrentEntry(libArchive);
+
+        if (!LIBARCHIVE_NextEntry(&reader))
+        {
+            if (reader.atEnd)
+                index.complete = true;
+            return false;
+        }
+    }
+}
+
+// Opens the reader of a lazy entry at the start of the entry
+static bool LIBARCHIVE_RestartLazyEntry(LIBARCHIVE_LazyEntry& lazyEntry)
+{
+    lazyEntry.decodedOffset = 0;
+    lazyEntry.window.clear();
+    lazyEntry.windowOffset = 0;
+
+    if (LIBARCHIVE_OpenReaderAtEntry(&lazyEntry.reader, lazyEntry.pathName, lazyEntry.ordinal, lazyEntry.headerOffset))
+        return true;
+    if (!LIBARCHIVE_OpenReader(&lazyEntry.reader, 0, 0))
+        return false;
+
+    while (lazyEntry.reader.currentOrdinal < lazyEntry.ordinal)
+    {
+        if (!LIBARCHIVE_NextEntry(&lazyEntry.reader))
+            return false;
+    }
+
+    auto pathName = archive_entry_pathname_utf8(lazyEntry.reader.currentEntry);
+    return pathName && lazyEntry.pathName == pathName;
+}
+
+// Decompresses a lazy entry until a position is in the kept data
+static bool LIBARCHIVE_DecodeLazyEntry(LIBARCHIVE_LazyEntry& lazyEntry, int64_t position)
+{
+    constexpr int64_t chunkSize = RAUDIO2_LIBARCHIVE_LAZY_CHUNK_SIZE;
+    constexpr size_t windowChunkCount = std::max(RAUDIO2_LIBARCHIVE_LAZY_WINDOW_SIZE / RAUDIO2_LIBARCHIVE_LAZY_CHUNK_SIZE, 1);
+
+    if (position < lazyEntry.decodedOffset || !lazyEntry.reader.archive_)
+    {
+        if (!LIBARCHIVE_RestartLazyEntry(lazyEntry))
+            return false;
+    }
+
+    while (lazyEntry.decodedOffset <= position)
+    {
+        std::vector<unsigned char> chunk((size_t)chunkSize);
+        auto bytesRead = archive_read_data(lazyEntry.reader.archive_, chunk.data(), chunk.size());
+        if (bytesRead <= 0)
+            return false;
+
+        chunk.resize((size_t)bytesRead);
+
+        if (lazyEntry.decodedOffset < (int64_t)RAUDIO2_LIBARCHIVE_LAZY_HEAD_SIZE && lazyEntry.head.size() == (size_t)lazyEntry.decodedOffset)
+        {
+            auto headBytes = std::min((size_t)bytesRead, (size_t)RAUDIO2_LIBARCHIVE_LAZY_HEAD_SIZE - lazyEntry.head.size());
+            lazyEntry.head.insert(lazyEntry.head.end(), chunk.begin(), chunk.begin() + headBytes);
+        }
+
+        if (lazyEntry.window.empty())
+            lazyEntry.windowOffset = lazyEntry.decodedOffset;
+
+        lazyEntry.window.push_back(std::move(chunk));
+        lazyEntry.decodedOffset += bytesRead;
+
+        if (lazyEntry.window.size() > windowChunkCount)
+        {
+            lazyEntry.windowOffset += (int64_t)lazyEntry.window.front().size();
+            lazyEntry.window.pop_front();
+        }
+    }
+    return true;
+}
+
+static int64_t LIBARCHIVE_ReadLazyEntry(LIBARCHIVE_LazyEntry& lazyEntry, unsigned char* bufferOut, int64_t position, int64_t bytesToRead)
+{
+    int64_t bytesRead = 0;
+    while (bytesRead < bytesToRead)
+    {
+        auto readPosition = position + bytesRead;
+        auto bytesLeft = bytesToRead - bytesRead;
+
+        if (readPosition < (int64_t)lazyEntry.head.size())
+        {
+            auto count = std::min(bytesLeft, (int64_t)lazyEntry.head.size() - readPosition);
+            std::memcpy(bufferOut + bytesRead, lazyEntry.head.data() + readPosition, (size_t)count);
+            bytesRead += count;
+            continue;
+        }
+
+        if (readPosition >= lazyEntry.windowOffset && readPosition < lazyEntry.decodedOffset)
+        {
+            // Chunks are full sized, except the last one of the entry
+            auto chunkSize = (int64_t)lazyEntry.window.front().size();
+            auto chunkIndex = (size_t)((readPosition - lazyEntry.windowOffset) / chunkSize);
+            auto chunkOffset = (readPosition - lazyEntry.windowOffset) % chunkSize;
+            auto& chunk = lazyEntry.window[chunkIndex];
+
+            auto count = std::min(bytesLeft, (int64_t)chunk.size() - chunkOffset);
+            std::memcpy(bufferOut + bytesRead, chunk.data() + chunkOffset, (size_t)count);
+            bytesRead += count;
+            continue;
+        }
+
+        if (!LIBARCHIVE_DecodeLazyEntry(lazyEntry, readPosition))
+            break;
+    }
+    return bytesRead;
+}
+
 bool LIBARCHIVE_FileOpen(RAudio2_Archive* archive_, const char* filePath, void** fileCtxOut)
 {
     *fileCtxOut = nullptr;
@@ -205,40 +906,109 @@ bool LIBARCHIVE_FileOpen(RAudio2_Archive* archive_, const char* filePath, void**
     if (!libArchiveFile)
         return false;
 
-    auto entry = libArchiveCtx->firstEntry;
+    libArchiveFile->libArchive = libArchiveCtx;
 
-    while (true)
+    std::lock_guard lock(libArchiveCtx->mutex);
+    std::lock_guard indexLock(libArchiveCtx->index->mutex);
+
+    std::string_view path(filePath ? filePath : "");
+
+    // Entries decompressed while walking a solid archive
+    if (!path.empty() && libArchiveCtx->solid)
     {
-        bool success = filePath == nullptr || filePath[0] == '\0';
-        if (!success)
+        libArchiveFile->fileBytes = LIBARCHIVE_FindCachedEntry(libArchiveCtx->archiveKey, path);
+        if (libArchiveFile->fileBytes)
         {
-            std::string_view pathName(archive_entry_pathname_utf8(entry));
-            success = pathName == filePath || pathName == "data"sv;
+            libArchiveFile->dataSize = (int64_t)libArchiveFile->fileBytes->size();
+
+            *fileCtxOut = libArchiveFile.release();
+            return true;
         }
-        if (success)
+    }
+
+    if (!LIBARCHIVE_FindEntry(libArchiveCtx, path))
+        return false;
+
+    auto& reader = libArchiveCtx->reader;
+    auto entry = reader.currentEntry;
+    auto pathName = archive_entry_pathname_utf8(entry);
+
+    // Stored entries seen before are read from the archive file once their header matched the index
+    // NOTE: Tar and zip readers reach the header directly, without walking the archive, the entry data follows it
+    if (pathName)
+    {
+        auto it = libArchiveCtx->index->entries.find(pathName);
+        auto dataOffset = reader.baseOffset + (int64_t)archive_filter_bytes(reader.archive_, 0);
+        if (it != libArchiveCtx->index->entries.end() && it->second.ordinal == reader.currentOrdinal &&
+            it->second.dataOffset >= 0 && it->second.dataOffset == dataOffset)
         {
-            const void* buff{};
-            size_t size{};
-            int64_t offset{};
-            int r = 0;
-            while ((r = archive_read_data_block(libArchiveCtx->archive_, &buff, &size, &offset)) == ARCHIVE_OK)
-            {
-                libArchiveFile->fileBytes.resize(libArchiveFile->fileBytes.size() + size);
-                std::memcpy(libArchiveFile->fileBytes.data() + offset, buff, size);
-            }
+            libArchiveFile->dataOffset = it->second.dataOffset;
+            libArchiveFile->dataSize = it->second.size;
 
             *fileCtxOut = libArchiveFile.release();
             return true;
         }
+    }
 
-        auto ret = archive_read_next_header2(libArchiveCtx->archive_, entry);
-        if (ret == ARCHIVE_EOF)
-            return false;
-        if (ret != ARCHIVE_OK)
-            return false;
+    reader.currentEntryRead = true;
+
+    const void* buff{};
+    size_t size{};
+    la_int64_t offset{};
+    int r = archive_read_data_block(reader.archive_, &buff, &size, &offset);
+
+    if (r == ARCHIVE_OK && LIBARCHIVE_IsStoredEntry(libArchiveCtx, buff, size, offset, libArchiveFile->dataOffset))
+    {
+        libArchiveFile->dataSize = (int64_t)archive_entry_size(entry);
+
+        if (pathName)
+        {
+            auto& indexEntry = libArchiveCtx->index->entries[pathName];
+            indexEntry.dataOffset = libArchiveFile->dataOffset;
+            indexEntry.size = libArchiveFile->dataSize;
+        }
+
+        *fileCtxOut = libArchiveFile.release();
+        return true;
     }
 
-    return false;
+    // Large entries of non solid archives are decompressed as they are read, by a reader of their own
+    if (r == ARCHIVE_OK && !libArchiveCtx->solid && pathName && archive_entry_size_is_set(entry) &&
+        archive_entry_size(entry) > RAUDIO2_LIBARCHIVE_LAZY_SIZE)
+    {
+        auto lazyEntry = std::make_unique<LIBARCHIVE_LazyEntry>();
+        lazyEntry->reader.file = reader.file;
+        lazyEntry->reader.fileMutex = &libArchiveCtx->fileMutex;
+        lazyEntry->reader.headerFormat = reader.headerFormat;
+        lazyEntry->ordinal = reader.currentOrdinal;
+        lazyEntry->pathName = pathName;
+
+        auto it = libArchiveCtx->index->entries.find(pathName);
+        if (it != libArchiveCtx->index->entries.end() && it->second.ordinal == reader.currentOrdinal)
+            lazyEntry->headerOffset = it->second.headerOffset;
+
+        libArchiveFile->dataSize = (int64_t)archive_entry_size(entry);
+        libArchiveFile->lazyEntry = std::move(lazyEntry);
+
+        *fileCtxOut = libArchiveFile.release();
+        return true;
+    }
+
+    auto fileBytes = std::make_shared<LIBARCHIVE_EntryData>();
+    if (archive_entry_size_is_set(entry))
+        fileBytes->reserve((size_t)archive_entry_size(entry));
+
+    r = LIBARCHIVE_ReadEntryData(reader.archive_, *fileBytes, r, buff, size, offset);
+
+    libArchiveFile->dataSize = (int64_t)fileBytes->size();
+    libArchiveFile->fileBytes = std::move(fileBytes);
+
+    // Reopening the entry later would decompress the solid stream up to it again
+    if (libArchiveCtx->solid && r == ARCHIVE_EOF && pathName && libArchiveFile->dataSize <= RAUDIO2_LIBARCHIVE_ENTRY_CACHE_BUDGET / 4)
+        LIBARCHIVE_CacheEntry(libArchiveCtx->archiveKey, pathName, libArchiveFile->fileBytes);
+
+    *fileCtxOut = libArchiveFile.release();
+    return true;
 }
 
 int64_t LIBARCHIVE_FileRead(void* fileCtx, void* bufferOut, int64_t bytesToRead)
@@ -247,16 +1017,30 @@ int64_t LIBARCHIVE_FileRead(void* fileCtx, void* bufferOut, int64_t bytesToRead)
     if (!libArchiveFile)
         return 0;
 
-    auto dataSize = (int64_t)libArchiveFile->fileBytes.size();
+    auto dataSize = libArchiveFile->dataSize;
     int64_t endPosition = libArchiveFile->currentOffset + bytesToRead;
     int64_t readBytes = endPosition <= dataSize ? bytesToRead : dataSize - libArchiveFile->currentOffset;
 
-    if (readBytes > 0)
+    if (readBytes <= 0)
+        return 0;
+
+    if (libArchiveFile->dataOffset >= 0)
     {
-        std::memcpy(bufferOut, libArchiveFile->fileBytes.data() + libArchiveFile->currentOffset, (size_t)readBytes);
-        libArchiveFile->currentOffset += readBytes;
+        auto libArchive = libArchiveFile->libArchive;
+        std::lock_guard lock(libArchive->fileMutex);
+
+        ra::VirtualIO file(libArchive->reader.file);
+        if (file.seek(libArchiveFile->dataOffset + libArchiveFile->currentOffset) != 0)
+            return 0;
+
+        readBytes = std::max(file.read(bufferOut, readBytes), (int64_t)0);
     }
+    else if (libArchiveFile->lazyEntry)
+        readBytes = LIBARCHIVE_ReadLazyEntry(*libArchiveFile->lazyEntry, (unsigned char*)bufferOut, libArchiveFile->currentOffset, readBytes);
+    else
+        std::memcpy(bufferOut, libArchiveFile->fileBytes->data() + libArchiveFile->currentOffset, (size_t)readBytes);
 
+    libArchiveFile->currentOffset += readBytes;
     return readBytes;
 }
 
@@ -266,7 +1050,7 @@ int64_t LIBARCHIVE_FileSeek(void* fileCtx, int64_t offset, int whence)
     if (!libArchiveFile)
         return -1;
 
-    auto dataSize = (int64_t)libArchiveFile->fileBytes.size();
+    auto dataSize = libArchiveFile->dataSize;
     auto newOffset = offset;
     switch (whence)
     {
@@ -299,7 +1083,7 @@ int64_t LIBARCHIVE_FileGetSize(void* fileCtx)
     if (!libArchiveFile)
         return 0;
 
-    return (int64_t)libArchiveFile->fileBytes.size();
+    return libArchiveFile->dataSize;
 }
 
 bool LIBARCHIVE_FileClose(void* fileCtx)
@@ -326,6 +1110,15 @@ bool LIBARCHIVE_GetValue(void* fileCtx, const char* key, int32_t keyLength, RAud
         return ra::MakeArrayValue(extensions, *valueOut);
         return true;
     }
+    case ra::str2int("plugin_signatures"): {
+        static const std::array<RAudio2_Signature, 11> signatures{ {
+            { 0, 4, "PK\x03\x04" }, { 0, 4, "PK\x05\x06" }, { 0, 6, "7z\xBC\xAF\x27\x1C" },
+            { 0, 6, "Rar!\x1A\x07" }, { 257, 5, "ustar" }, { 0, 2, "\x1F\x8B" },
+            { 0, 3, "BZh" }, { 0, 6, "\xFD" "7zXZ\x00" }, { 0, 4, "\x28\xB5\x2F\xFD" },
+            { 0, 4, "LZIP" }, {}
+        } };
+        return ra::MakeArrayValue(signatures, *valueOut);
+    }
     default: {
         break;
     }
@@ -3,6 +3,22 @@
 #include "raudio2/raudio2_archiveplugin.hpp"
 #include "raudio2/raudio2_config.h"
 
+#ifndef RAUDIO2_LIBARCHIVE_ENTRY_CACHE_BUDGET
+#define RAUDIO2_LIBARCHIVE_ENTRY_CACHE_BUDGET 67108864 // Maximum size of decompressed entries kept from solid archives (64 MiB)
+#endif
+#ifndef RAUDIO2_LIBARCHIVE_LAZY_SIZE
+#define RAUDIO2_LIBARCHIVE_LAZY_SIZE 4194304 // Compressed entries larger than this are decompressed as they are read (4 MiB)
+#endif
+#ifndef RAUDIO2_LIBARCHIVE_LAZY_CHUNK_SIZE
+#define RAUDIO2_LIBARCHIVE_LAZY_CHUNK_SIZE 65536 // Size of the chunks decompressed on demand
+#endif
+#ifndef RAUDIO2_LIBARCHIVE_LAZY_HEAD_SIZE
+#define RAUDIO2_LIBARCHIVE_LAZY_HEAD_SIZE 262144 // Start of an entry decompressed on demand kept for header probes
+#endif
+#ifndef RAUDIO2_LIBARCHIVE_LAZY_WINDOW_SIZE
+#define RAUDIO2_LIBARCHIVE_LAZY_WINDOW_SIZE 1048576 // Recently decompressed data kept for backward seeks
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
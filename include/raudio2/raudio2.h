@@ -128,17 +128,32 @@ RAUDIO2_API void RAUDIO2_CALL RAudio2_SetMasterVolume(RAUDIO2_HANDLE handle, flo
 RAUDIO2_API float RAUDIO2_CALL RAudio2_GetMasterVolume(RAUDIO2_HANDLE handle);
 
 // Get audio device value (key=input.wav.plugin_extensions returns the the list of supported file extensions by the wav plugin)
+// NOTE: block_cache.hits, block_cache.misses, block_cache.size, block_cache.budget and block_cache.block_count return shared block cache counters
 RAUDIO2_API bool RAUDIO2_CALL RAudio2_GetAudioDeviceValue(RAUDIO2_HANDLE handle, const char* key, int32_t keyLength, RAudio2_Value* valueOut);
 
 // Music management functions
 
 // Load music stream from file
+// "archive.zip|entry" loads an archive entry, a "|track=N" suffix selects a track in multi-track files (NSF, SPC, ...)
 RAUDIO2_API int32_t RAUDIO2_CALL RAudio2_LoadMusic(RAUDIO2_HANDLE handle, const char* fileName, bool streamFile);
 
+// Load music stream from file using RAudio2_LoadFlags
+RAUDIO2_API int32_t RAUDIO2_CALL RAudio2_LoadMusicEx(RAUDIO2_HANDLE handle, const char* fileName, int32_t loadFlags);
+
 // Load music stream from memory buffer, fileType refers to extension: i.e. ".wav"
 // WARNING: File extension must be provided in lower-case
 RAUDIO2_API int32_t RAUDIO2_CALL RAudio2_LoadMusicFromMemory(RAUDIO2_HANDLE handle, const char* fileType, const unsigned char* dataIn, int64_t dataSize);
 
+// Open an archive to load many music streams from it, using RAudio2_LoadFlags for the archive file
+// NOTE: The archive stays open until it is closed and every music loaded from it is unloaded
+RAUDIO2_API int32_t RAUDIO2_CALL RAudio2_OpenArchive(RAUDIO2_HANDLE handle, const char* fileName, int32_t loadFlags);
+
+// Load music stream from an entry of an open archive
+RAUDIO2_API int32_t RAUDIO2_CALL RAudio2_LoadMusicFromArchive(RAUDIO2_HANDLE handle, int32_t archiveId, const char* entryName);
+
+// Close an archive (musics loaded from it keep playing)
+RAUDIO2_API void RAUDIO2_CALL RAudio2_CloseArchive(RAUDIO2_HANDLE handle, int32_t archiveId);
+
 // Checks if a music stream is ready
 RAUDIO2_API bool RAUDIO2_CALL RAudio2_IsMusicReady(RAUDIO2_HANDLE handle, int32_t musicId);
 
@@ -155,5 +155,15 @@ namespace ra
         const std::string_view getName() const noexcept { return getStringView("plugin_name"sv); }
 
         const char** getExtensions() const noexcept { return getStringCharArray("plugin_extensions"sv); }
+
+        const RAudio2_Signature* getSignatures() const noexcept
+        {
+            Value value;
+            if (getValue(nullptr, "plugin_signatures"sv, value.getValue()))
+            {
+                return value.getSignatureArray("plugin_signatures"sv);
+            }
+            return {};
+        }
     };
 }
@@ -93,12 +93,30 @@ namespace ra
             pair.second = pair.first.Load(raHandle, fileName, streamFile);
             return pair;
         }
+        std::pair<Music, bool> LoadMusic(const char* fileName, int32_t loadFlags) noexcept
+        {
+            auto pair = std::make_pair(Music(), true);
+            pair.second = pair.first.Load(raHandle, fileName, loadFlags);
+            return pair;
+        }
         std::pair<Music, bool> LoadMusic(const char* fileType, const unsigned char* data, int64_t dataSize) noexcept
         {
             auto pair = std::make_pair(Music(), true);
             pair.second = pair.first.Load(raHandle, fileType, data, dataSize);
             return pair;
         }
+        std::pair<Music, bool> LoadMusic(int32_t archiveId, const char* entryName) noexcept
+        {
+            auto pair = std::make_pair(Music(), true);
+            pair.second = pair.first.Load(raHandle, archiveId, entryName);
+            return pair;
+        }
+
+        auto OpenArchive(const char* fileName, int32_t loadFlags = RAUDIO2_LOAD_FLAG_STREAM) const noexcept
+        {
+            return RAudio2_OpenArchive(raHandle, fileName, loadFlags);
+        }
+        void CloseArchive(int32_t archiveId) const noexcept { RAudio2_CloseArchive(raHandle, archiveId); }
 
         bool getValue(const char* key, int32_t keyLength, RAudio2_Value* valueOut) const noexcept
         {
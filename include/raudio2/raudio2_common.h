@@ -9,6 +9,17 @@ typedef enum
     RAUDIO2_FLAG_AUTOUPDATE
 } RAudio2_Flags;
 
+// Music load flags
+typedef enum
+{
+    RAUDIO2_LOAD_FLAG_NONE = 0,              // Read the whole file into memory
+    RAUDIO2_LOAD_FLAG_STREAM = 1 << 0,       // Stream the file from disk
+    RAUDIO2_LOAD_FLAG_MMAP = 1 << 1,         // Map the file into memory (read only), falls back to streaming if mapping fails
+    RAUDIO2_LOAD_FLAG_PREFETCH = 1 << 2,     // Stream the file from disk, reading ahead on a background thread
+    RAUDIO2_LOAD_FLAG_SHARED_CACHE = 1 << 3, // Stream the file through a block cache shared by all musics
+    RAUDIO2_LOAD_FLAG_PRELOAD = 1 << 4       // Decode the whole file when loading (plugins that support it decode in parallel)
+} RAudio2_LoadFlags;
+
 typedef enum
 {
     RAUDIO2_PLUGIN_ANY,
@@ -1,6 +1,7 @@
 #ifndef RAUDIO2_INPUTPLUGIN_H
 #define RAUDIO2_INPUTPLUGIN_H
 
+#include "raudio2_signature.h"
 #include "raudio2_value.h"
 #include "raudio2_waveinfo.h"
 #include <stdbool.h>
@@ -12,6 +13,8 @@ typedef int64_t (*RAudio2_InputPlugin_ReadFunc)(RAudio2_WaveInfo* wave, void* bu
 typedef bool (*RAudio2_InputPlugin_SeekFunc)(RAudio2_WaveInfo* wave, int64_t positionInFrames);
 typedef bool (*RAudio2_InputPlugin_CloseFunc)(RAudio2_WaveInfo* wave);
 typedef bool (*RAudio2_InputPlugin_GetValueFunc)(RAudio2_WaveInfo* wave, const char* key, int32_t keyLength, RAudio2_Value* valueOut);
+typedef int32_t (*RAudio2_InputPlugin_ProbeFunc)(const void* header, int64_t headerSize);
+typedef int64_t (*RAudio2_InputPlugin_ReadBorrowFunc)(RAudio2_WaveInfo* wave, const void** framesOut, int64_t maxFrames);
 
 typedef struct RAudio2_InputPlugin {
     int32_t flags;                         // should always be 0
@@ -22,9 +25,11 @@ typedef struct RAudio2_InputPlugin {
     RAudio2_InputPlugin_SeekFunc seek;
     RAudio2_InputPlugin_CloseFunc close;
     RAudio2_InputPlugin_GetValueFunc getValue;
+    RAudio2_InputPlugin_ProbeFunc probe;           // optional
+    RAudio2_InputPlugin_ReadBorrowFunc readBorrow; // optional, lends decoded frames instead of copying them
 
 #ifdef __cplusplus
-    RAudio2_InputPlugin() : flags{}, init{}, uninit{}, open{}, read{}, seek{}, close{}, getValue{}
+    RAudio2_InputPlugin() : flags{}, init{}, uninit{}, open{}, read{}, seek{}, close{}, getValue{}, probe{}, readBorrow{}
     {
     }
 #endif
@@ -26,15 +26,21 @@ namespace ra
         bool hasValidSeek() const noexcept { return plugin->seek != nullptr; }
         bool hasValidClose() const noexcept { return plugin->close != nullptr; }
         bool hasValidGetValue() const noexcept { return plugin->getValue != nullptr; }
+        bool hasValidProbe() const noexcept { return plugin->probe != nullptr; }
+        bool hasValidReadBorrow() const noexcept { return plugin->readBorrow != nullptr; }
 
         bool open(RAudio2_WaveInfo* wave) const noexcept { return plugin->open(wave); }
 
         auto read(RAudio2_WaveInfo* wave, void* bufferOut, int64_t framesToRead) const noexcept { return plugin->read(wave, bufferOut, framesToRead); }
 
+        auto readBorrow(RAudio2_WaveInfo* wave, const void** framesOut, int64_t maxFrames) const noexcept { return plugin->readBorrow(wave, framesOut, maxFrames); }
+
         bool seek(RAudio2_WaveInfo* wave, int64_t positionInFrames) const noexcept { return plugin->seek(wave, positionInFrames); }
 
         bool close(RAudio2_WaveInfo* wave) const noexcept { return plugin->close(wave); }
 
+        int32_t probe(const void* header, int64_t headerSize) const noexcept { return plugin->probe(header, headerSize); }
+
         bool getValue(RAudio2_WaveInfo* wave, const char* key, int32_t keyLength, RAudio2_Value* valueOut) const noexcept
         {
             return plugin->getValue(wave, key, keyLength, valueOut);
@@ -143,5 +149,15 @@ namespace ra
         const std::string_view getName() const noexcept { return getStringView("plugin_name"sv); }
 
         const char** getExtensions() const noexcept { return getStringCharArray("plugin_extensions"sv); }
+
+        const RAudio2_Signature* getSignatures() const noexcept
+        {
+            Value value;
+            if (getValue(nullptr, "plugin_signatures"sv, value.getValue()))
+            {
+                return value.getSignatureArray("plugin_signatures"sv);
+            }
+            return {};
+        }
     };
 }
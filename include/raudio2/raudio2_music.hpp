@@ -64,6 +64,34 @@ namespace ra
             raHandle = {};
             return false;
         }
+        bool Load(RAUDIO2_HANDLE handle, const char* fileName, int32_t loadFlags) noexcept
+        {
+            if (id || !handle)
+                return false;
+
+            id = RAudio2_LoadMusicEx(handle, fileName, loadFlags);
+            if (id != 0)
+            {
+                raHandle = handle;
+                return true;
+            }
+            raHandle = {};
+            return false;
+        }
+        bool Load(RAUDIO2_HANDLE handle, int32_t archiveId, const char* entryName) noexcept
+        {
+            if (id || !handle)
+                return false;
+
+            id = RAudio2_LoadMusicFromArchive(handle, archiveId, entryName);
+            if (id != 0)
+            {
+                raHandle = handle;
+                return true;
+            }
+            raHandle = {};
+            return false;
+        }
         bool Load(RAUDIO2_HANDLE handle, const char* fileType, const unsigned char* data, int64_t dataSize) noexcept
         {
             if (id || !handle)
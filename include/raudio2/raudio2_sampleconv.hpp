@@ -0,0 +1,248 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RAUDIO2_SAMPLECONV_SSE2
+#endif
+
+// Sample conversions shared by input plugins
+// Stereo conversions use SSE2 when available, other layouts rely on compiler auto-vectorization
+namespace ra
+{
+    // Float to signed 16 bit, rounded to nearest and clipped like libvorbisfile's ov_read
+    inline int16_t convertSampleToS16(float sample) noexcept
+    {
+        return (int16_t)std::lrint(std::clamp(sample * 32768.f, -32768.f, 32767.f));
+    }
+
+    // Converts planar integer samples (bitsPerSample <= 16) to interleaved signed 16 bit
+    // planes[channel][firstFrame + frame] is read for each converted frame
+    inline void convertPlanarToInterleavedS16(const int32_t* const* planes, int32_t channels, int64_t firstFrame,
+        int64_t frameCount, int32_t bitsPerSample, int16_t* samplesOut) noexcept
+    {
+        const int32_t shift = 16 - bitsPerSample;
+        const int32_t scale = 1 << shift;
+
+        if (channels == 1)
+        {
+            const int32_t* in = planes[0] + firstFrame;
+            for (int64_t i = 0; i < frameCount; i++)
+                samplesOut[i] = (int16_t)(in[i] * scale);
+            return;
+        }
+
+        if (channels == 2)
+        {
+            const int32_t* left = planes[0] + firstFrame;
+            const int32_t* right = planes[1] + firstFrame;
+            int64_t i = 0;
+#ifdef RAUDIO2_SAMPLECONV_SSE2
+            const __m128i shiftCount = _mm_cvtsi32_si128(shift);
+            for (const auto vectorFrames = frameCount & ~(int64_t)3; i < vectorFrames; i += 4)
+            {
+                auto l = _mm_sll_epi32(_mm_loadu_si128((const __m128i*)(left + i)), shiftCount);
+                auto r = _mm_sll_epi32(_mm_loadu_si128((const __m128i*)(right + i)), shiftCount);
+                auto interleaved = _mm_packs_epi32(_mm_unpacklo_epi32(l, r), _mm_unpackhi_epi32(l, r));
+                _mm_storeu_si128((__m128i*)(samplesOut + i * 2), interleaved);
+            }
+#endif
+            for (auto out = samplesOut + i * 2; i < frameCount; i++)
+            {
+                *out++ = (int16_t)(left[i] * scale);
+                *out++ = (int16_t)(right[i] * scale);
+            }
+            return;
+        }
+
+        for (int32_t channel = 0; channel < channels; channel++)
+        {
+            const int32_t* in = planes[channel] + firstFrame;
+            int16_t* out = samplesOut + channel;
+            for (int64_t i = 0; i < frameCount; i++)
+                out[i * channels] = (int16_t)(in[i] * scale);
+        }
+    }
+
+    // Converts planar integer samples to interleaved 32 bit float (-1.0 to 1.0)
+    // planes[channel][firstFrame + frame] is read for each converted frame
+    inline void convertPlanarToInterleavedF32(const int32_t* const* planes, int32_t channels, int64_t firstFrame,
+        int64_t frameCount, int32_t bitsPerSample, float* samplesOut) noexcept
+    {
+        const float scale = 1.f / (float)(1u << (bitsPerSample - 1));
+
+        if (channels == 1)
+        {
+            const int32_t* in = planes[0] + firstFrame;
+            for (int64_t i = 0; i < frameCount; i++)
+                samplesOut[i] = (float)in[i] * scale;
+            return;
+        }
+
+        if (channels == 2)
+        {
+            const int32_t* left = planes[0] + firstFrame;
+            const int32_t* right = planes[1] + firstFrame;
+            int64_t i = 0;
+#ifdef RAUDIO2_SAMPLECONV_SSE2
+            const __m128 scale4 = _mm_set1_ps(scale);
+            for (const auto vectorFrames = frameCount & ~(int64_t)3; i < vectorFrames; i += 4)
+            {
+                auto l = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(left + i))), scale4);
+                auto r = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(right + i))), scale4);
+                _mm_storeu_ps(samplesOut + i * 2, _mm_unpacklo_ps(l, r));
+                _mm_storeu_ps(samplesOut + i * 2 + 4, _mm_unpackhi_ps(l, r));
+            }
+#endif
+            for (auto out = samplesOut + i * 2; i < frameCount; i++)
+            {
+                *out++ = (float)left[i] * scale;
+                *out++ = (float)right[i] * scale;
+            }
+            return;
+        }
+
+        for (int32_t channel = 0; channel < channels; channel++)
+        {
+            const int32_t* in = planes[channel] + firstFrame;
+            float* out = samplesOut + channel;
+            for (int64_t i = 0; i < frameCount; i++)
+                out[i * channels] = (float)in[i] * scale;
+        }
+    }
+
+    // Converts planar float samples (-1.0 to 1.0) to interleaved signed 16 bit
+    // planes[channel][firstFrame + frame] is read for each converted frame
+    inline void convertPlanarToInterleavedS16(const float* const* planes, int32_t channels, int64_t firstFrame,
+        int64_t frameCount, int16_t* samplesOut) noexcept
+    {
+        if (channels == 1)
+        {
+            const float* in = planes[0] + firstFrame;
+            for (int64_t i = 0; i < frameCount; i++)
+                samplesOut[i] = convertSampleToS16(in[i]);
+            return;
+        }
+
+        if (channels == 2)
+        {
+            const float* left = planes[0] + firstFrame;
+            const float* right = planes[1] + firstFrame;
+            int64_t i = 0;
+#ifdef RAUDIO2_SAMPLECONV_SSE2
+            const __m128 scale4 = _mm_set1_ps(32768.f);
+            const __m128 min4 = _mm_set1_ps(-32768.f);
+            const __m128 max4 = _mm_set1_ps(32767.f);
+            for (const auto vectorFrames = frameCount & ~(int64_t)3; i < vectorFrames; i += 4)
+            {
+                auto l = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(left + i), scale4), min4), max4));
+                auto r = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(right + i), scale4), min4), max4));
+                auto interleaved = _mm_packs_epi32(_mm_unpacklo_epi32(l, r), _mm_unpackhi_epi32(l, r));
+                _mm_storeu_si128((__m128i*)(samplesOut + i * 2), interleaved);
+            }
+#endif
+            for (auto out = samplesOut + i * 2; i < frameCount; i++)
+            {
+                *out++ = convertSampleToS16(left[i]);
+                *out++ = convertSampleToS16(right[i]);
+            }
+            return;
+        }
+
+        for (int32_t channel = 0; channel < channels; channel++)
+        {
+            const float* in = planes[channel] + firstFrame;
+            int16_t* out = samplesOut + channel;
+            for (int64_t i = 0; i < frameCount; i++)
+                out[i * channels] = convertSampleToS16(in[i]);
+        }
+    }
+
+    // Converts planar float samples to interleaved 32 bit float
+    // planes[channel][firstFrame + frame] is read for each converted frame
+    inline void convertPlanarToInterleavedF32(const float* const* planes, int32_t channels, int64_t firstFrame,
+        int64_t frameCount, float* samplesOut) noexcept
+    {
+        if (channels == 1)
+        {
+            std::copy_n(planes[0] + firstFrame, frameCount, samplesOut);
+            return;
+        }
+
+        if (channels == 2)
+        {
+            const float* left = planes[0] + firstFrame;
+            const float* right = planes[1] + firstFrame;
+            int64_t i = 0;
+#ifdef RAUDIO2_SAMPLECONV_SSE2
+            for (const auto vectorFrames = frameCount & ~(int64_t)3; i < vectorFrames; i += 4)
+            {
+                auto l = _mm_loadu_ps(left + i);
+                auto r = _mm_loadu_ps(right + i);
+                _mm_storeu_ps(samplesOut + i * 2, _mm_unpacklo_ps(l, r));
+                _mm_storeu_ps(samplesOut + i * 2 + 4, _mm_unpackhi_ps(l, r));
+            }
+#endif
+            for (auto out = samplesOut + i * 2; i < frameCount; i++)
+            {
+                *out++ = left[i];
+                *out++ = right[i];
+            }
+            return;
+        }
+
+        for (int32_t channel = 0; channel < channels; channel++)
+        {
+            const float* in = planes[channel] + firstFrame;
+            float* out = samplesOut + channel;
+            for (int64_t i = 0; i < frameCount; i++)
+                out[i * channels] = in[i];
+        }
+    }
+
+    // Vorbis (and Opus mapping family 1) order surround channels differently from the default WAVE order
+    // the audio device converter assumes. Returns the source channel of each output channel,
+    // or nullptr when the channels are kept as they are (quad has no matching default layout)
+    inline const int32_t* getVorbisChannelOrder(int32_t channels) noexcept
+    {
+        static constexpr int32_t order3[]{ 0, 2, 1 };                   // L C R
+        static constexpr int32_t order5[]{ 0, 2, 1, 3, 4 };             // FL C FR RL RR
+        static constexpr int32_t order6[]{ 0, 2, 1, 5, 3, 4 };          // FL C FR RL RR LFE
+        static constexpr int32_t order7[]{ 0, 2, 1, 6, 5, 3, 4 };       // FL C FR SL SR RC LFE
+        static constexpr int32_t order8[]{ 0, 2, 1, 7, 5, 6, 3, 4 };    // FL C FR SL SR RL RR LFE
+
+        switch (channels)
+        {
+        case 3:
+            return order3;
+        case 5:
+            return order5;
+        case 6:
+            return order6;
+        case 7:
+            return order7;
+        case 8:
+            return order8;
+        default:
+            return nullptr;
+        }
+    }
+
+    // Reorders interleaved frames in place, channelOrder holds the source channel of each output channel
+    // Up to 8 channels
+    template <typename T>
+    inline void reorderInterleavedChannels(T* samples, int32_t channels, int64_t frameCount, const int32_t* channelOrder) noexcept
+    {
+        std::array<T, 8> frame{};
+        for (int64_t i = 0; i < frameCount; i++, samples += channels)
+        {
+            std::copy_n(samples, channels, frame.begin());
+            for (int32_t channel = 0; channel < channels; channel++)
+                samples[channel] = frame[channelOrder[channel]];
+        }
+    }
+}
@@ -0,0 +1,14 @@
+#ifndef RAUDIO2_SIGNATURE_H
+#define RAUDIO2_SIGNATURE_H
+
+#include <stdint.h>
+
+// Magic bytes identifying a file format
+// NOTE: Signature lists are terminated by an entry with size 0
+typedef struct RAudio2_Signature {
+    int32_t offset;    // Offset of the signature from the start of the file
+    int32_t size;      // Size of the signature in bytes
+    const char* bytes; // Signature bytes
+} RAudio2_Signature;
+
+#endif // RAUDIO2_SIGNATURE_H
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "raudio2_signature.h"
 #include "raudio2_value.h"
 #include <array>
 #include <string_view>
@@ -77,6 +78,15 @@ namespace ra
             }
             return {};
         }
+
+        const RAudio2_Signature* getSignatureArray(const std::string_view key) const noexcept
+        {
+            if (value.type == RAUDIO2_VALUE_POINTER)
+            {
+                return (const RAudio2_Signature*)value.value.ptr;
+            }
+            return {};
+        }
     };
 
     template <class T>
@@ -12,6 +12,18 @@ typedef int64_t (*RAudio2_VirtualIO_IOWrite)(void* handle, const void* bufferIn,
 typedef int64_t (*RAudio2_VirtualIO_IOSeek)(void* handle, int64_t offset, int whence);
 typedef int64_t (*RAudio2_VirtualIO_IOTell)(void* handle);
 typedef int64_t (*RAudio2_VirtualIO_IOGetSize)(void* handle);
+typedef const void* (*RAudio2_VirtualIO_IOGetBuffer)(void* handle, int64_t* sizeOut);
+
+// Identifies a file on disk, changes when the file is modified
+typedef struct RAudio2_FileIdentity {
+    uint64_t device;
+    uint64_t index;
+    int64_t modifiedTime;
+    int64_t changedTime;
+    int64_t size;
+} RAudio2_FileIdentity;
+
+typedef int32_t (*RAudio2_VirtualIO_IOGetIdentity)(void* handle, RAudio2_FileIdentity* identityOut);
 
 typedef struct RAudio2_VirtualIO {
     void* handle;
@@ -20,9 +32,11 @@ typedef struct RAudio2_VirtualIO {
     RAudio2_VirtualIO_IOSeek seek;
     RAudio2_VirtualIO_IOTell tell;
     RAudio2_VirtualIO_IOGetSize getSize;
+    RAudio2_VirtualIO_IOGetBuffer getBuffer;     // Optional, contiguous data of the whole file (memory or mapped files)
+    RAudio2_VirtualIO_IOGetIdentity getIdentity; // Optional, identity of the file on disk (returns 0 if it has none)
 
 #ifdef __cplusplus
-    RAudio2_VirtualIO() : handle{}, read{}, write{}, seek{}, tell{}, getSize{}
+    RAudio2_VirtualIO() : handle{}, read{}, write{}, seek{}, tell{}, getSize{}, getBuffer{}, getIdentity{}
     {
     }
 #endif
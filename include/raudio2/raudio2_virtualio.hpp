@@ -24,5 +24,25 @@ namespace ra
         int64_t tell() const noexcept { return io->tell(io->handle); }
 
         int64_t getSize() const noexcept { return io->getSize(io->handle); }
+
+        bool hasValidGetBuffer() const noexcept { return io->getBuffer != nullptr; }
+
+        // Returns the whole file data if the file is backed by memory, nullptr otherwise
+        const void* getBuffer(int64_t& sizeOut) const noexcept
+        {
+            sizeOut = 0;
+            if (!io->getBuffer)
+                return nullptr;
+            return io->getBuffer(io->handle, &sizeOut);
+        }
+
+        // Returns false if the file isn't a file on disk
+        bool getIdentity(RAudio2_FileIdentity& identityOut) const noexcept
+        {
+            identityOut = {};
+            if (!io->getIdentity)
+                return false;
+            return io->getIdentity(io->handle, &identityOut) != 0;
+        }
     };
 }
@@ -12,8 +12,18 @@ typedef struct RAudio2_WaveInfo {
     RAudio2_VirtualIO* file; // Audio file
     void* ctxData;           // Audio context data, depends on type
 
+    // Audio device output format, plugins that can produce it directly avoid a conversion (0 if unknown)
+    int32_t preferredSampleFormat; // Preferred sample format (RAudio2_SampleFormat)
+    int32_t preferredSampleRate;   // Preferred frequency (samples per second)
+    int32_t preferredChannels;     // Preferred number of channels
+
+    int32_t loadFlags; // Music load flags (RAudio2_LoadFlags)
+    int32_t track;     // Track to open in files holding several tracks ("file|track=N", 0 = first)
+
 #ifdef __cplusplus
-    RAudio2_WaveInfo() : sampleFormat{}, sampleRate{}, channels{}, frameCount{}, file{}, ctxData{}
+    RAudio2_WaveInfo() : sampleFormat{}, sampleRate{}, channels{}, frameCount{}, file{}, ctxData{},
+                         preferredSampleFormat{}, preferredSampleRate{}, preferredChannels{},
+                         loadFlags{}, track{}
     {
     }
 #endif
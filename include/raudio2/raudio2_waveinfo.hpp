@@ -46,6 +46,17 @@ namespace ra
         auto getFrameCount() const noexcept { return wave->frameCount; }
         VirtualIO getFile() const noexcept { return wave->file; }
         auto getCtxData() const noexcept { return wave->ctxData; }
+        auto getPreferredSampleFormat() const noexcept { return wave->preferredSampleFormat; }
+        auto getPreferredSampleRate() const noexcept { return wave->preferredSampleRate; }
+        auto getPreferredChannels() const noexcept { return wave->preferredChannels; }
+        auto getLoadFlags() const noexcept { return wave->loadFlags; }
+        auto getTrack() const noexcept { return wave->track; }
+
+        // Preferred sample rate, or defaultSampleRate if the device didn't provide one
+        int32_t getPreferredSampleRate(int32_t defaultSampleRate) const noexcept
+        {
+            return wave->preferredSampleRate > 0 ? wave->preferredSampleRate : defaultSampleRate;
+        }
 
         void setSampleFormat(RAudio2_SampleFormat sampleFormat) noexcept { wave->sampleFormat = (int32_t)sampleFormat; }
         void setSampleRate(int32_t sampleRate) noexcept { wave->sampleRate = sampleRate; }
@@ -74,12 +85,16 @@ namespace ra
 
         int64_t framesToMilliseconds(int64_t positionInFrames) const noexcept
         {
-            return positionInFrames / (int64_t)(wave->sampleRate * wave->channels);
+            if (wave->sampleRate <= 0)
+                return 0;
+            return positionInFrames * 1000 / (int64_t)wave->sampleRate;
         }
 
         double framesToSeconds(int64_t positionInFrames) const noexcept
         {
-            return (double)framesToMilliseconds(positionInFrames) / 1000.0;
+            if (wave->sampleRate <= 0)
+                return 0.0;
+            return (double)positionInFrames / (double)wave->sampleRate;
         }
     };
 }
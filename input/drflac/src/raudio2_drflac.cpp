@@ -1,8 +1,15 @@
 #include "raudio2_drflac.h"
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstring>
+#include <memory>
 #include "raudio2/raudio2_common.hpp"
 #include "raudio2/raudio2_value.hpp"
 #include "raudio2/raudio2_virtualio.hpp"
+#include "raudio2/raudio2_waveinfo.hpp"
+#include <thread>
+#include <vector>
 
 using namespace std::literals;
 
@@ -57,32 +64,149 @@ static drflac_bool32 DRFLAC_OnSeek(void* pUserData, int offset, drflac_seek_orig
     return file.seek(offset, (origin == drflac_seek_origin_current) ? RAUDIO2_SEEK_CUR : RAUDIO2_SEEK_SET) == 0;
 }
 
-bool DRFLAC_Open(RAudio2_WaveInfo* wave)
+struct DRFLAC_Music {
+    drflac* flac{ nullptr };
+
+    // Whole file decoded at open (RAUDIO2_LOAD_FLAG_PRELOAD), read instead of the decoder when not empty
+    std::vector<unsigned char> decodedFrames;
+    int64_t decodedFrameCount{ 0 };
+    int64_t decodedOffset{ 0 }; // In frames
+    int64_t bytesPerFrame{ 0 };
+
+    ~DRFLAC_Music()
+    {
+        if (flac)
+            drflac_close(flac);
+    }
+};
+
+static int64_t DRFLAC_ReadFrames(drflac* flac, int64_t framesToRead, void* bufferOut)
 {
-    if (!wave)
+    if (flac->bitsPerSample <= 16)
+        return (int64_t)drflac_read_pcm_frames_s16(flac, (drflac_uint64)framesToRead, (drflac_int16*)bufferOut);
+    else
+        return (int64_t)drflac_read_pcm_frames_f32(flac, (drflac_uint64)framesToRead, (float*)bufferOut);
+}
+
+// Decodes the whole file in chunks of frames spread over worker threads
+// FLAC frames are independent, each worker opens its own decoder on the file data and seeks to its chunks
+static bool DRFLAC_Preload(DRFLAC_Music* music, ra::VirtualIO file)
+{
+    auto flac = music->flac;
+
+    // Ogg seeking walks pages from the start, chunks would not be independent
+    if (flac->container != drflac_container_native || flac->totalPCMFrameCount == 0)
         return false;
-    if (!wave->file)
+
+    int64_t fileSize{};
+    auto fileData = file.getBuffer(fileSize);
+
+    std::vector<unsigned char> fileBytes;
+    if (!fileData)
+    {
+        fileSize = file.getSize();
+        if (fileSize <= 0 || file.seek(0) != 0)
+            return false;
+
+        fileBytes.resize((size_t)fileSize);
+        if (file.read(fileBytes.data(), fileSize) != fileSize)
+            return false;
+        fileData = fileBytes.data();
+    }
+
+    auto frameCount = (int64_t)flac->totalPCMFrameCount;
+    music->bytesPerFrame = (int64_t)flac->channels * (flac->bitsPerSample <= 16 ? (int64_t)sizeof(drflac_int16) : (int64_t)sizeof(float));
+    music->decodedFrames.resize((size_t)(frameCount * music->bytesPerFrame));
+
+    const int64_t chunkFrames = RAUDIO2_DRFLAC_PRELOAD_CHUNK_FRAMES;
+    const int64_t chunkCount = (frameCount + chunkFrames - 1) / chunkFrames;
+    auto threadCount = (int64_t)std::clamp(std::thread::hardware_concurrency(), 1u, (unsigned)RAUDIO2_DRFLAC_MAX_THREADS);
+    threadCount = std::min(threadCount, chunkCount);
+
+    std::atomic<int64_t> nextChunk{ 0 };
+    std::atomic<bool> failed{ false };
+    std::atomic<int64_t> lastChunkFrames{ 0 };
+
+    auto decodeChunks = [&]() {
+        auto chunkFlac = drflac_open_memory(fileData, (size_t)fileSize, nullptr);
+        if (!chunkFlac)
+        {
+            failed = true;
+            return;
+        }
+
+        for (auto chunk = nextChunk++; chunk < chunkCount && !failed; chunk = nextChunk++)
+        {
+            auto firstFrame = chunk * chunkFrames;
+            auto framesToRead = std::min(chunkFrames, frameCount - firstFrame);
+
+            if (!drflac_seek_to_pcm_frame(chunkFlac, (drflac_uint64)firstFrame))
+            {
+                failed = true;
+                break;
+            }
+
+            auto framesRead = DRFLAC_ReadFrames(chunkFlac, framesToRead, music->decodedFrames.data() + firstFrame * music->bytesPerFrame);
+
+            // Only the stream info total can be wrong, a truncated file ends in the last chunk
+            if (chunk == chunkCount - 1)
+                lastChunkFrames = framesRead;
+            else if (framesRead != framesToRead)
+                failed = true;
+        }
+
+        drflac_close(chunkFlac);
+    };
+
+    std::vector<std::thread> workers;
+    for (int64_t i = 1; i < threadCount; i++)
+        workers.emplace_back(decodeChunks);
+    decodeChunks();
+    for (auto& worker : workers)
+        worker.join();
+
+    if (failed)
+    {
+        music->decodedFrames = {};
         return false;
-    if (!wave->file->handle)
+    }
+
+    music->decodedFrameCount = (chunkCount - 1) * chunkFrames + lastChunkFrames;
+    music->decodedOffset = 0;
+    return true;
+}
+
+bool DRFLAC_Open(RAudio2_WaveInfo* wave_)
+{
+    ra::WaveInfo wave = wave_;
+    if (!wave.hasValidFile())
         return false;
 
-    drflac* ctxFlac = drflac_open(DRFLAC_OnRead, DRFLAC_OnSeek, wave->file, nullptr);
+    auto music = std::make_unique<DRFLAC_Music>();
 
-    wave->ctxData = ctxFlac;
+    music->flac = drflac_open(DRFLAC_OnRead, DRFLAC_OnSeek, wave.getFile().getVirtualIO(), nullptr);
+    if (!music->flac)
+        return false;
+
+    auto ctxFlac = music->flac;
 
-    if (wave->ctxData != nullptr)
+    if ((wave.getLoadFlags() & RAUDIO2_LOAD_FLAG_PRELOAD) && !DRFLAC_Preload(music.get(), wave.getFile()))
     {
-        if (ctxFlac->bitsPerSample <= 16)
-            wave->sampleFormat = RAUDIO2_SAMPLE_FORMAT_S16;
-        else
-            wave->sampleFormat = RAUDIO2_SAMPLE_FORMAT_F32;
-
-        wave->sampleRate = (int32_t)ctxFlac->sampleRate;
-        wave->channels = (int32_t)ctxFlac->channels;
-        wave->frameCount = (int64_t)ctxFlac->totalPCMFrameCount;
-        return true;
+        // Keep streaming from the decoder
+        drflac__seek_to_first_frame(ctxFlac);
     }
-    return false;
+
+    if (ctxFlac->bitsPerSample <= 16)
+        wave.setSampleFormat(RAUDIO2_SAMPLE_FORMAT_S16);
+    else
+        wave.setSampleFormat(RAUDIO2_SAMPLE_FORMAT_F32);
+
+    wave.setSampleRate((int32_t)ctxFlac->sampleRate);
+    wave.setChannels((int32_t)ctxFlac->channels);
+    wave.setFrameCount(music->decodedFrames.empty() ? (int64_t)ctxFlac->totalPCMFrameCount : music->decodedFrameCount);
+
+    wave.setCtxData(music.release());
+    return true;
 }
 
 bool DRFLAC_Seek(RAudio2_WaveInfo* wave, int64_t positionInFrames)
@@ -96,10 +220,18 @@ bool DRFLAC_Seek(RAudio2_WaveInfo* wave, int64_t positionInFrames)
     if (!wave->ctxData)
         return false;
 
+    auto music = (DRFLAC_Music*)wave->ctxData;
+
+    if (!music->decodedFrames.empty())
+    {
+        music->decodedOffset = std::clamp(positionInFrames, (int64_t)0, music->decodedFrameCount);
+        return true;
+    }
+
     if (positionInFrames <= 0)
-        return drflac__seek_to_first_frame((drflac*)wave->ctxData) == DRFLAC_TRUE;
+        return drflac__seek_to_first_frame(music->flac) == DRFLAC_TRUE;
 
-    return drflac_seek_to_pcm_frame((drflac*)wave->ctxData, (drflac_uint64)positionInFrames) == DRFLAC_TRUE;
+    return drflac_seek_to_pcm_frame(music->flac, (drflac_uint64)positionInFrames) == DRFLAC_TRUE;
 }
 
 int64_t DRFLAC_Read(RAudio2_WaveInfo* wave, void* bufferOut, int64_t framesToRead)
@@ -113,12 +245,20 @@ int64_t DRFLAC_Read(RAudio2_WaveInfo* wave, void* bufferOut, int64_t framesToRea
     if (!wave->ctxData)
         return 0;
 
-    auto ctxFlac = (drflac*)wave->ctxData;
+    auto music = (DRFLAC_Music*)wave->ctxData;
 
-    if (ctxFlac->bitsPerSample <= 16)
-        return drflac_read_pcm_frames_s16(ctxFlac, (drflac_uint64)framesToRead, (drflac_int16*)bufferOut);
-    else
-        return drflac_read_pcm_frames_f32(ctxFlac, (drflac_uint64)framesToRead, (float*)bufferOut);
+    if (!music->decodedFrames.empty())
+    {
+        auto framesRead = std::min(framesToRead, music->decodedFrameCount - music->decodedOffset);
+        if (framesRead <= 0)
+            return 0;
+
+        std::memcpy(bufferOut, music->decodedFrames.data() + music->decodedOffset * music->bytesPerFrame, (size_t)(framesRead * music->bytesPerFrame));
+        music->decodedOffset += framesRead;
+        return framesRead;
+    }
+
+    return DRFLAC_ReadFrames(music->flac, framesToRead, bufferOut);
 }
 
 bool DRFLAC_Close(RAudio2_WaveInfo* wave)
@@ -128,7 +268,7 @@ bool DRFLAC_Close(RAudio2_WaveInfo* wave)
     if (!wave->ctxData)
         return false;
 
-    drflac_free((drflac*)wave->ctxData, NULL);
+    delete (DRFLAC_Music*)wave->ctxData;
     wave->ctxData = nullptr;
     return true;
 }
@@ -147,11 +287,17 @@ bool DRFLAC_GetValue(RAudio2_WaveInfo* wave, const char* key, int32_t keyLength,
         return ra::MakeArrayValue(extensions, *valueOut);
         return true;
     }
+    case ra::str2int("plugin_signatures"): {
+        static const std::array<RAudio2_Signature, 3> signatures{ { { 0, 4, "fLaC" }, { 28, 5, "\x7F" "FLAC" }, {} } };
+        return ra::MakeArrayValue(signatures, *valueOut);
+    }
     default: {
-        auto ctxFlac = (drflac*)wave->ctxData;
-        if (!ctxFlac)
+        auto music = (DRFLAC_Music*)wave->ctxData;
+        if (!music)
             break;
 
+        auto ctxFlac = music->flac;
+
         switch (keyHash)
         {
         case ra::str2int("bps"):
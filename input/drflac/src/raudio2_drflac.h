@@ -3,6 +3,13 @@
 #include "raudio2/raudio2_config.h"
 #include "raudio2/raudio2_inputplugin.hpp"
 
+#ifndef RAUDIO2_DRFLAC_PRELOAD_CHUNK_FRAMES
+#define RAUDIO2_DRFLAC_PRELOAD_CHUNK_FRAMES 262144 // Frames decoded by a worker at a time when preloading
+#endif
+#ifndef RAUDIO2_DRFLAC_MAX_THREADS
+#define RAUDIO2_DRFLAC_MAX_THREADS 8 // Maximum threads decoding a preloaded file
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
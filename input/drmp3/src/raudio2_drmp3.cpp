@@ -1,7 +1,14 @@
 #include "raudio2_drmp3.h"
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <climits>
+#include <memory>
 #include "raudio2/raudio2_common.hpp"
 #include "raudio2/raudio2_value.hpp"
+#include "raudio2/raudio2_waveinfo.hpp"
+#include <thread>
+#include <vector>
 
 using namespace std::literals;
 
@@ -32,6 +39,7 @@ bool DRMP3_MakeInputPlugin(RAudio2_InputPlugin* plugin)
     plugin->read = DRMP3_Read;
     plugin->close = DRMP3_Close;
     plugin->getValue = DRMP3_GetValue;
+    plugin->probe = DRMP3_Probe;
 
     return true;
 }
@@ -56,29 +64,235 @@ static drmp3_bool32 DRMP3_OnSeek(void* pUserData, int offset, drmp3_seek_origin
     return file->seek(file->handle, offset, (origin == drmp3_seek_origin_current) ? RAUDIO2_SEEK_CUR : RAUDIO2_SEEK_SET) == 0;
 }
 
-bool DRMP3_Open(RAudio2_WaveInfo* wave)
+int32_t DRMP3_Probe(const void* header, int64_t headerSize)
 {
-    if (!wave)
-        return false;
-    if (!wave->file)
+    auto data = (const drmp3_uint8*)header;
+
+    // raw streams start with a frame header, look for 2 consecutive frames near the start
+    for (int64_t i = 0; i < 1024 && i + DRMP3_HDR_SIZE <= headerSize; i++)
+    {
+        if (!drmp3_hdr_valid(data + i))
+            continue;
+
+        auto frameSize = (int64_t)drmp3_hdr_frame_bytes(data + i, 0);
+        if (frameSize <= 0)
+            continue;
+
+        auto next = i + frameSize + drmp3_hdr_padding(data + i);
+        if (next + DRMP3_HDR_SIZE > headerSize)
+            return i == 0 ? 30 : 0;
+
+        if (drmp3_hdr_compare(data + i, data + next))
+            return 75;
+    }
+    return 0;
+}
+
+struct DRMP3_Music {
+    drmp3 mp3{};
+    bool initialized{ false };
+
+    // Whole file decoded at open (RAUDIO2_LOAD_FLAG_PRELOAD), read instead of the decoder when not empty
+    // NOTE: Kept as s16 like the decoder output, converted to float when read
+    std::vector<drmp3_int16> decodedSamples;
+    int64_t decodedFrameCount{ 0 };
+    int64_t decodedOffset{ 0 }; // In frames
+
+    ~DRMP3_Music()
+    {
+        if (initialized)
+            drmp3_uninit(&mp3);
+    }
+};
+
+// MP3 frame found by the preload scan
+struct DRMP3_FrameInfo {
+    int64_t offset;      // Offset of the data fed to the decoder for this frame (includes junk skipped before it)
+    int32_t size;        // Bytes consumed by the decoder for this frame
+    int32_t pcmFrames;   // Frames decoded from this frame by a sequential decode (0 if the decoder drops it)
+    int64_t firstOutput; // Position of the frame in the decoded output
+};
+
+// Decodes the next MP3 frame from data + offset, returns false at the end of the data
+// frameFound is false if only junk was skipped
+static bool DRMP3_DecodeFrame(drmp3dec* decoder, const drmp3_uint8* data, int64_t dataSize, int64_t& offset, drmp3_int16* pcm, int32_t& pcmFrames, bool& frameFound)
+{
+    drmp3dec_frame_info info{};
+    pcmFrames = drmp3dec_decode_frame(decoder, data + offset, (int)(dataSize - offset), pcm, &info);
+    if (info.frame_bytes <= 0)
         return false;
-    if (!wave->file->handle)
+
+    offset += info.frame_bytes;
+    frameFound = info.hz != 0;
+    return true;
+}
+
+// Number of frames to decode before a chunk so its first frame decodes as in a sequential decode
+// Layer 3 frames may take up to 511 bytes of their data from previous frames (bit reservoir)
+// and the synthesis filter bank keeps the output of the previous frame
+static int64_t DRMP3_WarmupFrames(const std::vector<DRMP3_FrameInfo>& frames, int64_t firstFrame)
+{
+    constexpr int32_t ReservoirSize = 511;
+    constexpr int32_t FrameOverhead = 4 + 32 + 2; // Header, largest side info, CRC
+
+    // The frame before the chunk is decoded to fill the filter bank, the ones before it fill its reservoir
+    int64_t warmupFrames = std::min((int64_t)1, firstFrame);
+    int32_t reservoirBytes = 0;
+    while (warmupFrames < firstFrame && reservoirBytes < ReservoirSize)
+    {
+        reservoirBytes += std::max(frames[(size_t)(firstFrame - warmupFrames - 1)].size - FrameOverhead, 0);
+        warmupFrames++;
+    }
+    return warmupFrames;
+}
+
+// Splits the file into chunks of MP3 frames decoded by worker threads into one buffer
+// Each worker decodes a few frames before its chunk so the output matches a sequential decode exactly
+static bool DRMP3_Preload(DRMP3_Music* music, ra::VirtualIO file)
+{
+    int64_t fileSize{};
+    auto fileData = (const drmp3_uint8*)file.getBuffer(fileSize);
+
+    std::vector<drmp3_uint8> fileBytes;
+    if (!fileData)
+    {
+        fileSize = file.getSize();
+        if (fileSize <= 0 || file.seek(0) != 0)
+            return false;
+
+        fileBytes.resize((size_t)fileSize);
+        if (file.read(fileBytes.data(), fileSize) != fileSize)
+            return false;
+        fileData = fileBytes.data();
+    }
+
+    // The decoder takes int sizes
+    if (fileSize > INT_MAX)
         return false;
 
-    drmp3* ctxMp3 = (drmp3*)calloc(1, sizeof(drmp3));
-    bool success = drmp3_init(ctxMp3, DRMP3_OnRead, DRMP3_OnSeek, wave->file, nullptr) == DRMP3_TRUE;
+    auto channels = (int32_t)music->mp3.channels;
+
+    // Scan the frames without synthesizing them, the decoder keeps track of the reservoir to report dropped frames
+    std::vector<DRMP3_FrameInfo> frames;
+    {
+        drmp3dec decoder;
+        drmp3dec_init(&decoder);
+
+        int64_t offset = 0;
+        int64_t firstOutput = 0;
+        int32_t pcmFrames{};
+        bool frameFound{};
+        for (auto frameOffset = offset; DRMP3_DecodeFrame(&decoder, fileData, fileSize, offset, nullptr, pcmFrames, frameFound); frameOffset = offset)
+        {
+            if (!frameFound)
+                continue;
+
+            // Frames are copied as a block of the stream's channel count, a layout change needs the sequential path
+            if ((DRMP3_HDR_IS_MONO(decoder.header) ? 1 : 2) != channels)
+                return false;
+
+            frames.push_back({ frameOffset, (int32_t)(offset - frameOffset), pcmFrames, firstOutput });
+            firstOutput += pcmFrames;
+        }
+
+        if (frames.empty())
+            return false;
+        music->decodedFrameCount = firstOutput;
+    }
+
+    music->decodedSamples.resize((size_t)(music->decodedFrameCount * channels));
+
+    const auto frameCount = (int64_t)frames.size();
+    const int64_t chunkFrames = RAUDIO2_DRMP3_PRELOAD_CHUNK_FRAMES;
+    const int64_t chunkCount = (frameCount + chunkFrames - 1) / chunkFrames;
+    auto threadCount = (int64_t)std::clamp(std::thread::hardware_concurrency(), 1u, (unsigned)RAUDIO2_DRMP3_MAX_THREADS);
+    threadCount = std::min(threadCount, chunkCount);
+
+    std::atomic<int64_t> nextChunk{ 0 };
+    std::atomic<bool> failed{ false };
+
+    auto decodeChunks = [&]() {
+        drmp3dec decoder;
+        std::vector<drmp3_int16> pcm(DRMP3_MAX_SAMPLES_PER_FRAME);
+
+        for (auto chunk = nextChunk++; chunk < chunkCount && !failed; chunk = nextChunk++)
+        {
+            auto firstFrame = chunk * chunkFrames;
+            auto lastFrame = std::min(firstFrame + chunkFrames, frameCount);
+            auto frame = firstFrame - DRMP3_WarmupFrames(frames, firstFrame);
+            auto offset = frames[(size_t)frame].offset;
+
+            drmp3dec_init(&decoder);
+            while (frame < lastFrame)
+            {
+                // Only the last warmup frame needs to be synthesized
+                auto output = frame >= firstFrame - 1 ? pcm.data() : nullptr;
+
+                int32_t pcmFrames{};
+                bool frameFound{};
+                if (!DRMP3_DecodeFrame(&decoder, fileData, fileSize, offset, output, pcmFrames, frameFound))
+                    break;
+                if (!frameFound)
+                    continue;
+
+                if (frame >= firstFrame)
+                {
+                    const auto& frameInfo = frames[(size_t)frame];
+                    if (pcmFrames != frameInfo.pcmFrames || offset != frameInfo.offset + frameInfo.size)
+                        break;
 
-    wave->ctxData = ctxMp3;
+                    std::copy_n(pcm.data(), pcmFrames * channels, music->decodedSamples.data() + frameInfo.firstOutput * channels);
+                }
+                frame++;
+            }
 
-    if (success && ctxMp3 != nullptr)
+            if (frame != lastFrame)
+                failed = true;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int64_t i = 1; i < threadCount; i++)
+        workers.emplace_back(decodeChunks);
+    decodeChunks();
+    for (auto& worker : workers)
+        worker.join();
+
+    if (failed)
     {
-        wave->sampleFormat = RAUDIO2_SAMPLE_FORMAT_F32;
-        wave->sampleRate = (int32_t)ctxMp3->sampleRate;
-        wave->channels = (int32_t)ctxMp3->channels;
-        wave->frameCount = (int64_t)drmp3_get_pcm_frame_count(ctxMp3);
-        return true;
+        music->decodedSamples = {};
+        music->decodedFrameCount = 0;
+        return false;
     }
-    return false;
+
+    music->decodedOffset = 0;
+    return true;
+}
+
+bool DRMP3_Open(RAudio2_WaveInfo* wave_)
+{
+    ra::WaveInfo wave = wave_;
+    if (!wave.hasValidFile())
+        return false;
+
+    auto music = std::make_unique<DRMP3_Music>();
+
+    // drmp3_init cleans up after itself on failure
+    music->initialized = drmp3_init(&music->mp3, DRMP3_OnRead, DRMP3_OnSeek, wave.getFile().getVirtualIO(), nullptr) == DRMP3_TRUE;
+    if (!music->initialized)
+        return false;
+
+    auto ctxMp3 = &music->mp3;
+
+    bool preloaded = (wave.getLoadFlags() & RAUDIO2_LOAD_FLAG_PRELOAD) && DRMP3_Preload(music.get(), wave.getFile());
+
+    wave.setSampleFormat(RAUDIO2_SAMPLE_FORMAT_F32);
+    wave.setSampleRate((int32_t)ctxMp3->sampleRate);
+    wave.setChannels((int32_t)ctxMp3->channels);
+    wave.setFrameCount(preloaded ? music->decodedFrameCount : (int64_t)drmp3_get_pcm_frame_count(ctxMp3));
+
+    wave.setCtxData(music.release());
+    return true;
 }
 
 bool DRMP3_Seek(RAudio2_WaveInfo* wave, int64_t positionInFrames)
@@ -92,10 +306,18 @@ bool DRMP3_Seek(RAudio2_WaveInfo* wave, int64_t positionInFrames)
     if (!wave->ctxData)
         return false;
 
+    auto music = (DRMP3_Music*)wave->ctxData;
+
+    if (!music->decodedSamples.empty())
+    {
+        music->decodedOffset = std::clamp(positionInFrames, (int64_t)0, music->decodedFrameCount);
+        return true;
+    }
+
     if (positionInFrames <= 0)
-        return drmp3_seek_to_start_of_stream((drmp3*)wave->ctxData) == DRMP3_TRUE;
+        return drmp3_seek_to_start_of_stream(&music->mp3) == DRMP3_TRUE;
 
-    return drmp3_seek_to_pcm_frame((drmp3*)wave->ctxData, (drmp3_uint64)positionInFrames) == DRMP3_TRUE;
+    return drmp3_seek_to_pcm_frame(&music->mp3, (drmp3_uint64)positionInFrames) == DRMP3_TRUE;
 }
 
 int64_t DRMP3_Read(RAudio2_WaveInfo* wave, void* bufferOut, int64_t framesToRead)
@@ -109,7 +331,22 @@ int64_t DRMP3_Read(RAudio2_WaveInfo* wave, void* bufferOut, int64_t framesToRead
     if (!wave->ctxData)
         return 0;
 
-    return drmp3_read_pcm_frames_f32((drmp3*)wave->ctxData, (drmp3_uint64)framesToRead, (float*)bufferOut);
+    auto music = (DRMP3_Music*)wave->ctxData;
+
+    if (!music->decodedSamples.empty())
+    {
+        auto framesRead = std::min(framesToRead, music->decodedFrameCount - music->decodedOffset);
+        if (framesRead <= 0)
+            return 0;
+
+        // Same conversion as drmp3_read_pcm_frames_f32
+        auto channels = (int64_t)music->mp3.channels;
+        drmp3_s16_to_f32((float*)bufferOut, music->decodedSamples.data() + music->decodedOffset * channels, (drmp3_uint64)(framesRead * channels));
+        music->decodedOffset += framesRead;
+        return framesRead;
+    }
+
+    return drmp3_read_pcm_frames_f32(&music->mp3, (drmp3_uint64)framesToRead, (float*)bufferOut);
 }
 
 bool DRMP3_Close(RAudio2_WaveInfo* wave)
@@ -119,8 +356,7 @@ bool DRMP3_Close(RAudio2_WaveInfo* wave)
     if (!wave->ctxData)
         return false;
 
-    drmp3_uninit((drmp3*)wave->ctxData);
-    DRMP3_FREE(wave->ctxData);
+    delete (DRMP3_Music*)wave->ctxData;
     wave->ctxData = nullptr;
     return true;
 }
@@ -138,9 +374,13 @@ bool DRMP3_GetValue(RAudio2_WaveInfo* wave, const char* key, int32_t keyLength,
         static const std::array<const char*, 4> extensions{ ".mp3", ".mp2", ".mp1", nullptr };
         return ra::MakeArrayValue(extensions, *valueOut);
     }
+    case ra::str2int("plugin_signatures"): {
+        static const std::array<RAudio2_Signature, 2> signatures{ { { 0, 3, "ID3" }, {} } };
+        return ra::MakeArrayValue(signatures, *valueOut);
+    }
     default: {
-        auto ctxMp3 = (drmp3*)wave->ctxData;
-        if (!ctxMp3)
+        auto music = (DRMP3_Music*)wave->ctxData;
+        if (!music)
             break;
 
         switch (keyHash)
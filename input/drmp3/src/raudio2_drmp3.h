@@ -3,6 +3,13 @@
 #include "raudio2/raudio2_config.h"
 #include "raudio2/raudio2_inputplugin.hpp"
 
+#ifndef RAUDIO2_DRMP3_PRELOAD_CHUNK_FRAMES
+#define RAUDIO2_DRMP3_PRELOAD_CHUNK_FRAMES 256 // MP3 frames decoded by a worker at a time when preloading
+#endif
+#ifndef RAUDIO2_DRMP3_MAX_THREADS
+#define RAUDIO2_DRMP3_MAX_THREADS 8 // Maximum threads decoding a preloaded file
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -23,6 +30,8 @@ bool DRMP3_Close(RAudio2_WaveInfo* wave);
 
 bool DRMP3_GetValue(RAudio2_WaveInfo* wave, const char* key, int32_t keyLength, RAudio2_Value* valueOut);
 
+int32_t DRMP3_Probe(const void* header, int64_t headerSize);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,9 +1,14 @@
 #include "raudio2_flac.h"
+#include <algorithm>
 #include <array>
+#include <cstring>
 #include <FLAC/all.h>
+#include <memory>
 #include "raudio2/raudio2_common.hpp"
+#include "raudio2/raudio2_sampleconv.hpp"
 #include "raudio2/raudio2_value.hpp"
 #include "raudio2/raudio2_waveinfo.hpp"
+#include <vector>
 
 using namespace std::literals;
 
@@ -26,9 +31,45 @@ bool FLAC_MakeInputPlugin(RAudio2_InputPlugin* plugin)
     return true;
 }
 
+struct FLAC_Music {
+    FLAC__StreamDecoder* decoder{ nullptr };
+    RAudio2_VirtualIO* file{ nullptr };
+
+    bool hasStreamInfo{ false };
+    uint32_t sampleRate{ 0 };
+    uint32_t channels{ 0 };
+    uint32_t bitsPerSample{ 0 };
+    uint64_t totalSamples{ 0 };
+    bool floatOutput{ false };
+    int64_t bytesPerFrame{ 0 };
+
+    // Output of the read being served, frames are decoded straight into it when they fit
+    unsigned char* directOut{ nullptr };
+    int64_t directFrames{ 0 };
+
+    // Decoded frames not returned yet (converted to the output format), reused for every frame
+    std::vector<unsigned char> pending;
+    int64_t pendingOffset{ 0 }; // In frames
+    int64_t pendingFrames{ 0 };
+
+    ~FLAC_Music()
+    {
+        if (decoder)
+            FLAC__stream_decoder_delete(decoder);
+    }
+};
+
+static void FLAC_ConvertFrames(const FLAC_Music* music, const FLAC__int32* const buffer[], int64_t firstFrame, int64_t frameCount, unsigned char* bufferOut)
+{
+    if (music->floatOutput)
+        ra::convertPlanarToInterleavedF32(buffer, (int32_t)music->channels, firstFrame, frameCount, (int32_t)music->bitsPerSample, (float*)bufferOut);
+    else
+        ra::convertPlanarToInterleavedS16(buffer, (int32_t)music->channels, firstFrame, frameCount, (int32_t)music->bitsPerSample, (int16_t*)bufferOut);
+}
+
 static FLAC__StreamDecoderReadStatus FLAC_OnRead(const FLAC__StreamDecoder* decoder, FLAC__byte buffer[], size_t* bytes, void* client_data)
 {
-    RAudio2_VirtualIO* file = (RAudio2_VirtualIO*)client_data;
+    RAudio2_VirtualIO* file = ((FLAC_Music*)client_data)->file;
     if (*bytes > 0)
     {
         *bytes = file->read(file->handle, buffer, *bytes);
@@ -43,7 +84,7 @@ static FLAC__StreamDecoderReadStatus FLAC_OnRead(const FLAC__StreamDecoder* deco
 
 static FLAC__StreamDecoderSeekStatus FLAC_OnSeek(const FLAC__StreamDecoder* decoder, FLAC__uint64 absolute_byte_offset, void* client_data)
 {
-    RAudio2_VirtualIO* file = (RAudio2_VirtualIO*)client_data;
+    RAudio2_VirtualIO* file = ((FLAC_Music*)client_data)->file;
 
     if (!file)
         return FLAC__STREAM_DECODER_SEEK_STATUS_ERROR;
@@ -57,7 +98,7 @@ static FLAC__StreamDecoderSeekStatus FLAC_OnSeek(const FLAC__StreamDecoder* deco
 
 static FLAC__StreamDecoderTellStatus FLAC_OnTell(const FLAC__StreamDecoder* decoder, FLAC__uint64* absolute_byte_offset, void* client_data)
 {
-    RAudio2_VirtualIO* file = (RAudio2_VirtualIO*)client_data;
+    RAudio2_VirtualIO* file = ((FLAC_Music*)client_data)->file;
 
     if (!file)
         return FLAC__STREAM_DECODER_TELL_STATUS_ERROR;
@@ -72,7 +113,7 @@ static FLAC__StreamDecoderTellStatus FLAC_OnTell(const FLAC__StreamDecoder* deco
 
 static FLAC__StreamDecoderLengthStatus FLAC_OnLength(const FLAC__StreamDecoder* decoder, FLAC__uint64* stream_length, void* client_data)
 {
-    RAudio2_VirtualIO* file = (RAudio2_VirtualIO*)client_data;
+    RAudio2_VirtualIO* file = ((FLAC_Music*)client_data)->file;
 
     if (!file)
         return FLAC__STREAM_DECODER_LENGTH_STATUS_ERROR;
@@ -87,7 +128,7 @@ static FLAC__StreamDecoderLengthStatus FLAC_OnLength(const FLAC__StreamDecoder*
 
 static FLAC__bool FLAC_OnEof(const FLAC__StreamDecoder* decoder, void* client_data)
 {
-    RAudio2_VirtualIO* file = (RAudio2_VirtualIO*)client_data;
+    RAudio2_VirtualIO* file = ((FLAC_Music*)client_data)->file;
 
     return file->tell(file->handle) >= file->getSize(file->handle);
 }
@@ -117,12 +158,56 @@ static FLAC__bool FLAC_OnEof(const FLAC__StreamDecoder* decoder, void* client_da
 //    The callee's return status.
 static FLAC__StreamDecoderWriteStatus FLAC_OnDecoderWrite(const FLAC__StreamDecoder* decoder, const FLAC__Frame* frame, const FLAC__int32* const buffer[], void* client_data)
 {
-    return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
+    auto music = (FLAC_Music*)client_data;
+
+    // The output format is fixed at open, frames must match the stream info
+    if (frame->header.channels != music->channels || frame->header.bits_per_sample != music->bitsPerSample)
+        return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
+
+    auto frameCount = (int64_t)frame->header.blocksize;
+
+    // Convert what fits into the output of the current read, queue the rest
+    auto directFrames = std::min(frameCount, music->directFrames);
+    if (directFrames > 0)
+    {
+        FLAC_ConvertFrames(music, buffer, 0, directFrames, music->directOut);
+        music->directOut += directFrames * music->bytesPerFrame;
+        music->directFrames -= directFrames;
+    }
+
+    auto pendingFrames = frameCount - directFrames;
+    if (pendingFrames > 0)
+    {
+        auto pendingSize = (size_t)(pendingFrames * music->bytesPerFrame);
+        if (music->pending.size() < pendingSize)
+            music->pending.resize(pendingSize);
+
+        FLAC_ConvertFrames(music, buffer, directFrames, pendingFrames, music->pending.data());
+    }
+    music->pendingOffset = 0;
+    music->pendingFrames = pendingFrames;
+
+    return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
 }
 
 static void FLAC_OnMetadata(const FLAC__StreamDecoder* decoder, const FLAC__StreamMetadata* metadata, void* client_data)
 {
-    //metadata->type
+    auto music = (FLAC_Music*)client_data;
+
+    if (metadata->type != FLAC__METADATA_TYPE_STREAMINFO)
+        return;
+
+    const auto& streamInfo = metadata->data.stream_info;
+    music->hasStreamInfo = true;
+    music->sampleRate = streamInfo.sample_rate;
+    music->channels = streamInfo.channels;
+    music->bitsPerSample = streamInfo.bits_per_sample;
+    music->totalSamples = streamInfo.total_samples;
+
+    // A frame never holds more than max_blocksize frames, size the queue once
+    music->floatOutput = music->bitsPerSample > 16;
+    music->bytesPerFrame = (int64_t)music->channels * (music->floatOutput ? (int64_t)sizeof(float) : (int64_t)sizeof(int16_t));
+    music->pending.resize((size_t)(streamInfo.max_blocksize * music->bytesPerFrame));
 }
 
 static void FLAC_OnError(const FLAC__StreamDecoder* decoder, FLAC__StreamDecoderErrorStatus status, void* client_data)
@@ -155,8 +240,11 @@ bool FLAC_Open(RAudio2_WaveInfo* wave_)
 
     file.seek(0);
 
-    auto flacFile = FLAC__stream_decoder_new();
+    auto flacMusic = std::make_unique<FLAC_Music>();
+    flacMusic->file = file.getVirtualIO();
+    flacMusic->decoder = FLAC__stream_decoder_new();
 
+    auto flacFile = flacMusic->decoder;
     if (!flacFile)
         return false;
 
@@ -166,30 +254,29 @@ bool FLAC_Open(RAudio2_WaveInfo* wave_)
     FLAC__StreamDecoderInitStatus ret{};
     if (isOgg)
         ret = FLAC__stream_decoder_init_ogg_stream(flacFile, FLAC_OnRead, FLAC_OnSeek, FLAC_OnTell,
-            FLAC_OnLength, FLAC_OnEof, FLAC_OnDecoderWrite, FLAC_OnMetadata, FLAC_OnError, file.getVirtualIO());
+            FLAC_OnLength, FLAC_OnEof, FLAC_OnDecoderWrite, FLAC_OnMetadata, FLAC_OnError, flacMusic.get());
     else
         ret = FLAC__stream_decoder_init_stream(flacFile, FLAC_OnRead, FLAC_OnSeek, FLAC_OnTell,
-            FLAC_OnLength, FLAC_OnEof, FLAC_OnDecoderWrite, FLAC_OnMetadata, FLAC_OnError, file.getVirtualIO());
+            FLAC_OnLength, FLAC_OnEof, FLAC_OnDecoderWrite, FLAC_OnMetadata, FLAC_OnError, flacMusic.get());
 
-    if (ret == FLAC__STREAM_DECODER_INIT_STATUS_OK)
-    {
-        FLAC__stream_decoder_process_until_end_of_metadata(flacFile);
-        FLAC__stream_decoder_process_single(flacFile);
+    if (ret != FLAC__STREAM_DECODER_INIT_STATUS_OK)
+        return false;
 
-        if (FLAC__stream_decoder_get_bits_per_sample(flacFile) <= 16)
-            wave.setSampleFormat(RAUDIO2_SAMPLE_FORMAT_S16);
-        else
-            wave.setSampleFormat(RAUDIO2_SAMPLE_FORMAT_F32);
+    // Samples are converted using the stream info, it must come before any frame
+    if (!FLAC__stream_decoder_process_until_end_of_metadata(flacFile) || !flacMusic->hasStreamInfo)
+        return false;
 
-        wave.setChannels(FLAC__stream_decoder_get_channels(flacFile));
-        wave.setSampleRate(FLAC__stream_decoder_get_sample_rate(flacFile));
-        wave.setFrameCount(FLAC__stream_decoder_get_total_samples(flacFile));
+    if (flacMusic->channels == 0 || flacMusic->bitsPerSample < 4 || flacMusic->bitsPerSample > 32)
+        return false;
 
-        wave.setCtxData(flacFile);
+    wave.setSampleFormat(flacMusic->floatOutput ? RAUDIO2_SAMPLE_FORMAT_F32 : RAUDIO2_SAMPLE_FORMAT_S16);
+    wave.setChannels((int32_t)flacMusic->channels);
+    wave.setSampleRate((int32_t)flacMusic->sampleRate);
+    wave.setFrameCount((int64_t)flacMusic->totalSamples);
 
-        return true;
-    }
-    return false;
+    wave.setCtxData(flacMusic.release());
+
+    return true;
 }
 
 bool FLAC_Seek(RAudio2_WaveInfo* wave, int64_t positionInFrames)
@@ -203,9 +290,23 @@ bool FLAC_Seek(RAudio2_WaveInfo* wave, int64_t positionInFrames)
     if (!wave->ctxData)
         return false;
 
-    auto flacFile = (FLAC__StreamDecoder*)wave->ctxData;
+    auto music = (FLAC_Music*)wave->ctxData;
 
-    return FLAC__stream_decoder_seek_absolute(flacFile, positionInFrames) != 0;
+    if (positionInFrames <= 0)
+        positionInFrames = 0;
+
+    // The decoder delivers the frame holding the target from the target on, queue it
+    music->pendingFrames = 0;
+    music->directFrames = 0;
+
+    if (FLAC__stream_decoder_seek_absolute(music->decoder, (FLAC__uint64)positionInFrames))
+        return true;
+
+    // A failed seek leaves the decoder unusable until it is flushed
+    if (FLAC__stream_decoder_get_state(music->decoder) == FLAC__STREAM_DECODER_SEEK_ERROR)
+        FLAC__stream_decoder_flush(music->decoder);
+    music->pendingFrames = 0;
+    return false;
 }
 
 int64_t FLAC_Read(RAudio2_WaveInfo* wave_, void* bufferOut, int64_t framesToRead)
@@ -215,10 +316,42 @@ int64_t FLAC_Read(RAudio2_WaveInfo* wave_, void* bufferOut, int64_t framesToRead
     if (!wave)
         return 0;
 
-    auto flacFile = (FLAC__StreamDecoder*)wave_->ctxData;
+    auto music = (FLAC_Music*)wave.getCtxData();
+    if (!music)
+        return 0;
+
+    auto out = (unsigned char*)bufferOut;
+    int64_t framesRead = 0;
+
+    // Frames left over from the previous frame first
+    if (music->pendingFrames > 0)
+    {
+        auto frames = std::min(music->pendingFrames, framesToRead);
+        std::memcpy(out, music->pending.data() + music->pendingOffset * music->bytesPerFrame, (size_t)(frames * music->bytesPerFrame));
+        music->pendingOffset += frames;
+        music->pendingFrames -= frames;
+        framesRead += frames;
+    }
+
+    // Then decode straight into the output, the write callback queues what doesn't fit
+    music->directOut = out + framesRead * music->bytesPerFrame;
+    music->directFrames = framesToRead - framesRead;
+
+    while (music->directFrames > 0)
+    {
+        if (!FLAC__stream_decoder_process_single(music->decoder))
+            break;
+
+        auto state = FLAC__stream_decoder_get_state(music->decoder);
+        if (state == FLAC__STREAM_DECODER_END_OF_STREAM || state == FLAC__STREAM_DECODER_ABORTED)
+            break;
+    }
 
-    //return drflac_read_pcm_frames_s16((drflac*)wave->ctxData, framesToRead, (drflac_int16*)bufferOut);
-    return 0;
+    framesRead = framesToRead - music->directFrames;
+    music->directOut = nullptr;
+    music->directFrames = 0;
+
+    return framesRead;
 }
 
 bool FLAC_Close(RAudio2_WaveInfo* wave)
@@ -228,9 +361,7 @@ bool FLAC_Close(RAudio2_WaveInfo* wave)
     if (!wave->ctxData)
         return false;
 
-    auto flacFile = (FLAC__StreamDecoder*)wave->ctxData;
-
-    FLAC__stream_decoder_delete(flacFile);
+    delete (FLAC_Music*)wave->ctxData;
     wave->ctxData = nullptr;
     return true;
 }
@@ -248,6 +379,10 @@ bool FLAC_GetValue(RAudio2_WaveInfo* wave, const char* key, int32_t keyLength, R
         static const std::array<const char*, 4> extensions{ ".flac", ".oga", ".ogg", nullptr };
         return ra::MakeArrayValue(extensions, *valueOut);
     }
+    case ra::str2int("plugin_signatures"): {
+        static const std::array<RAudio2_Signature, 3> signatures{ { { 0, 4, "fLaC" }, { 28, 5, "\x7F" "FLAC" }, {} } };
+        return ra::MakeArrayValue(signatures, *valueOut);
+    }
     default: {
         break;
     }
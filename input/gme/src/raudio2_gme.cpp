@@ -1,5 +1,9 @@
 #include "raudio2_gme.h"
+#include <algorithm>
+#include <array>
+#include <deque>
 #include <gme/gme.h>
+#include <mutex>
 #include "raudio2/raudio2_common.hpp"
 #include "raudio2/raudio2_value.hpp"
 #include "raudio2/raudio2_waveinfo.hpp"
@@ -30,8 +34,82 @@ struct GME_Music {
     Music_Emu* music{ nullptr };
     gme_info_t* info{ nullptr };
     const char* format{ nullptr };
+    int32_t track{};
+    int32_t trackCount{};
+    int32_t sampleRate{};
+    RAudio2_FileIdentity identity{}; // File the emulator was loaded from, if it is a file on disk
+    bool hasIdentity{};
 };
 
+// Emulators of closed musics, the next music of the same file reuses one instead of loading and parsing the file again
+// NOTE: An emulator plays one track at a time, musics of the same file open together each load their own
+struct GME_CachedEmu {
+    RAudio2_FileIdentity identity{};
+    int32_t sampleRate{};
+    Music_Emu* music{ nullptr };
+};
+
+struct GME_EmuCache {
+    std::deque<GME_CachedEmu> emus; // Most recently closed first
+    std::mutex mutex;
+
+    ~GME_EmuCache()
+    {
+        for (auto& emu : emus)
+            gme_delete(emu.music);
+    }
+};
+
+static GME_EmuCache emuCache;
+
+static bool GME_SameFile(const RAudio2_FileIdentity& a, const RAudio2_FileIdentity& b)
+{
+    return a.device == b.device && a.index == b.index && a.modifiedTime == b.modifiedTime &&
+           a.changedTime == b.changedTime && a.size == b.size;
+}
+
+static Music_Emu* GME_TakeCachedEmu(const RAudio2_FileIdentity& identity, int32_t sampleRate)
+{
+    std::lock_guard lock(emuCache.mutex);
+
+    auto it = std::find_if(emuCache.emus.begin(), emuCache.emus.end(), [&](const GME_CachedEmu& emu) {
+        return emu.sampleRate == sampleRate && GME_SameFile(emu.identity, identity);
+    });
+    if (it == emuCache.emus.end())
+        return nullptr;
+
+    auto music = it->music;
+    emuCache.emus.erase(it);
+    return music;
+}
+
+static void GME_CacheEmu(const RAudio2_FileIdentity& identity, int32_t sampleRate, Music_Emu* music)
+{
+    Music_Emu* droppedMusic = nullptr;
+    {
+        std::lock_guard lock(emuCache.mutex);
+
+        emuCache.emus.push_front({ identity, sampleRate, music });
+        if (emuCache.emus.size() > RAUDIO2_GME_EMULATOR_CACHE_SIZE)
+        {
+            droppedMusic = emuCache.emus.back().music;
+            emuCache.emus.pop_back();
+        }
+    }
+
+    if (droppedMusic)
+        gme_delete(droppedMusic);
+}
+
+// Feeds the emulator straight from the file instead of copying the whole file first
+static gme_err_t GME_ReadFile(void* userData, void* out, int count)
+{
+    ra::VirtualIO file = (RAudio2_VirtualIO*)userData;
+    if (file.read(out, count) != count)
+        return "Couldn't read from file";
+    return nullptr;
+}
+
 bool GME_Open(RAudio2_WaveInfo* wave_)
 {
     ra::WaveInfo wave = wave_;
@@ -43,63 +121,78 @@ bool GME_Open(RAudio2_WaveInfo* wave_)
     if (!file)
         return false;
 
-    auto fileSize = file.getSize();
-
-    std::vector<unsigned char> fileBytes;
-    fileBytes.resize(4);
-    if (file.read(fileBytes.data(), 4) != 4)
+    std::array<unsigned char, 4> header{};
+    if (file.read(header.data(), (int64_t)header.size()) != (int64_t)header.size())
         return false;
 
     const char* format = nullptr;
-    if (!(format = gme_identify_header(fileBytes.data())))
+    if (!(format = gme_identify_header(header.data())))
         return false;
 
     auto file_type = gme_identify_extension(format);
     if (!file_type)
         return false;
 
-    fileBytes.resize((size_t)fileSize);
-    file.read(fileBytes.data() + 4, fileSize - 4);
-
-    Music_Emu* music = nullptr;
-    if (!(music = gme_new_emu(file_type, 44100)))
-        return false;
-
-    auto err = gme_load_data(music, fileBytes.data(), (long)fileBytes.size());
-    if (err)
-        return false;
+    // synthesize at the device rate to skip resampling
+    auto sampleRate = wave.getPreferredSampleRate(44100);
 
-    int count = gme_track_count(music);
+    // Another track of a file played before reuses its loaded emulator, "file|track=N" picks the one to play
+    RAudio2_FileIdentity identity{};
+    bool hasIdentity = file.getIdentity(identity);
 
-    if (count < 1)
-        return false;
-
-    gme_start_track(music, 0);
-    gme_info_t* track_info;
-    err = gme_track_info(music, &track_info, 0);
-    if (err)
-        return false;
-
-    if (music)
+    gme_err_t err = nullptr;
+    Music_Emu* music = hasIdentity ? GME_TakeCachedEmu(identity, sampleRate) : nullptr;
+    if (!music)
     {
-        auto gmeMusic = new GME_Music();
-        if (!gmeMusic)
+        if (!(music = gme_new_emu(file_type, sampleRate)))
             return false;
 
-        gmeMusic->music = music;
-        gmeMusic->info = track_info;
-        gmeMusic->format = format;
+        // Load from the file data directly when it is already in memory, otherwise stream it in
+        int64_t fileSize{};
+        auto fileData = file.getBuffer(fileSize);
+
+        if (fileData)
+        {
+            err = gme_load_data(music, fileData, (long)fileSize);
+        }
+        else
+        {
+            fileSize = file.getSize();
+            file.seek(0, RAUDIO2_SEEK_SET);
+            err = gme_load_custom(music, GME_ReadFile, (long)fileSize, file.getVirtualIO());
+        }
+    }
 
-        wave.setCtxData(gmeMusic);
+    auto track = wave.getTrack();
+    int count = err ? 0 : gme_track_count(music);
 
-        wave.setSampleFormat(RAUDIO2_SAMPLE_FORMAT_S16);
-        wave.setSampleRate(44100);
-        wave.setChannels(2);
-        wave.setFrameCount((int64_t)(((float)(track_info->intro_length + track_info->loop_length) / 1000.f) * 44100.f * 2.f));
-        return true;
+    gme_info_t* track_info = nullptr;
+    if (track >= count || gme_track_info(music, &track_info, track) || gme_start_track(music, track))
+    {
+        if (track_info)
+            gme_free_info(track_info);
+        gme_delete(music);
+        return false;
     }
 
-    return false;
+    auto gmeMusic = new GME_Music();
+    gmeMusic->music = music;
+    gmeMusic->info = track_info;
+    gmeMusic->format = format;
+    gmeMusic->track = track;
+    gmeMusic->trackCount = count;
+    gmeMusic->sampleRate = sampleRate;
+    gmeMusic->identity = identity;
+    gmeMusic->hasIdentity = hasIdentity;
+
+    wave.setCtxData(gmeMusic);
+
+    // play_length falls back to intro + 2 loops, or 2.5 minutes when the length is unknown
+    wave.setSampleFormat(RAUDIO2_SAMPLE_FORMAT_S16);
+    wave.setSampleRate(sampleRate);
+    wave.setChannels(2);
+    wave.setFrameCount((int64_t)track_info->play_length * sampleRate / 1000);
+    return true;
 }
 
 bool GME_Seek(RAudio2_WaveInfo* wave, int64_t positionInFrames)
@@ -118,7 +211,8 @@ bool GME_Seek(RAudio2_WaveInfo* wave, int64_t positionInFrames)
 
     auto music = (GME_Music*)wave->ctxData;
 
-    return gme_seek(music->music, (int)(positionInFrames / (wave->sampleRate * wave->channels))) == nullptr;
+    // gme counts samples of both channels
+    return gme_seek_samples(music->music, (int)(positionInFrames * wave->channels)) == nullptr;
 }
 
 int64_t GME_Read(RAudio2_WaveInfo* wave, void* bufferOut, int64_t framesToRead)
@@ -137,7 +231,7 @@ int64_t GME_Read(RAudio2_WaveInfo* wave, void* bufferOut, int64_t framesToRead)
     if (gme_track_ended(music->music))
         return 0;
 
-    if (gme_play(music->music, (int)framesToRead * 2, (short*)bufferOut))
+    if (gme_play(music->music, (int)(framesToRead * wave->channels), (short*)bufferOut))
         return 0;
 
     return framesToRead;
@@ -156,7 +250,12 @@ bool GME_Close(RAudio2_WaveInfo* wave)
         gme_free_info(gmeMusic->info);
 
     if (gmeMusic->music)
-        gme_delete(gmeMusic->music);
+    {
+        if (gmeMusic->hasIdentity)
+            GME_CacheEmu(gmeMusic->identity, gmeMusic->sampleRate, gmeMusic->music);
+        else
+            gme_delete(gmeMusic->music);
+    }
 
     delete gmeMusic;
     wave->ctxData = nullptr;
@@ -182,6 +281,15 @@ bool GME_GetValue(RAudio2_WaveInfo* wave_, const char* key, int32_t keyLength, R
         };
         return ra::MakeArrayValue(extensions, *valueOut);
     }
+    case ra::str2int("plugin_signatures"): {
+        static const std::array<RAudio2_Signature, 12> signatures{ {
+            { 0, 4, "Vgm " }, { 0, 8, "ZXAYEMUL" }, { 0, 3, "GBS" },
+            { 0, 4, "GYMX" }, { 0, 4, "HESM" }, { 0, 4, "KSCC" },
+            { 0, 4, "KSSX" }, { 0, 5, "NESM\x1A" }, { 0, 4, "NSFE" },
+            { 0, 5, "SAP\r\n" }, { 0, 27, "SNES-SPC700 Sound File Data" }, {}
+        } };
+        return ra::MakeArrayValue(signatures, *valueOut);
+    }
     default: {
         auto gmeMusic = (GME_Music*)wave.getCtxData();
         if (!gmeMusic || !gmeMusic->info)
@@ -212,6 +320,12 @@ bool GME_GetValue(RAudio2_WaveInfo* wave_, const char* key, int32_t keyLength, R
         case ra::str2int("system"): {
             return ra::MakeValue(gmeMusic->info->system, *valueOut);
         }
+        case ra::str2int("track"): {
+            return ra::MakeValue(gmeMusic->track, *valueOut);
+        }
+        case ra::str2int("track_count"): {
+            return ra::MakeValue(gmeMusic->trackCount, *valueOut);
+        }
         case ra::str2int("bps"):
         case ra::str2int("current_bps"): {
             return ra::MakeValue(wave.calculateBps(), *valueOut);
@@ -3,6 +3,10 @@
 #include "raudio2/raudio2_config.h"
 #include "raudio2/raudio2_inputplugin.hpp"
 
+#ifndef RAUDIO2_GME_EMULATOR_CACHE_SIZE
+#define RAUDIO2_GME_EMULATOR_CACHE_SIZE 4 // Loaded emulators kept after their music is closed, for the other tracks of the file
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -1,6 +1,8 @@
 #include "raudio2_modplug.h"
 #include <array>
+#include <cstring>
 #include <libmodplug/modplug.h>
+#include <mutex>
 #include "raudio2/raudio2_common.hpp"
 #include "raudio2/raudio2_value.hpp"
 #include "raudio2/raudio2_waveinfo.hpp"
@@ -8,8 +10,36 @@
 
 using namespace std::literals;
 
+// libmodplug mixes with process wide settings and buffers, so every call into it is serialized
+// and each music applies its own settings again when another music changed them.
+// Rate, bits and channels are only applied by ModPlug_Load, to every loaded module at once,
+// so they stay fixed while any module is loaded and later musics mix with them too
+static std::mutex modplugMutex;
 static ModPlug_Settings modplugSettings{ 0 };
 static unsigned int modplugMasterVolume{ 512 };
+static int modplugLoadedCount{ 0 };
+
+struct MODPLUG_Music
+{
+    ModPlugFile* file{ nullptr };
+    ModPlug_Settings settings{};
+};
+
+// Applies the mixing and resampling settings, ModPlug_SetSettings ignores rate, bits and channels
+// Must be called with modplugMutex locked
+static void MODPLUG_ApplySettings(const ModPlug_Settings& settings)
+{
+    auto mixingSettings = settings;
+    mixingSettings.mFrequency = modplugSettings.mFrequency;
+    mixingSettings.mBits = modplugSettings.mBits;
+    mixingSettings.mChannels = modplugSettings.mChannels;
+
+    if (std::memcmp(&mixingSettings, &modplugSettings, sizeof(ModPlug_Settings)) == 0)
+        return;
+
+    modplugSettings = mixingSettings;
+    ModPlug_SetSettings(&modplugSettings);
+}
 
 #ifdef RAUDIO2_STANDALONE_PLUGIN
 bool RAudio2_GetInputPlugin(RAudio2_InputPlugin* plugin)
@@ -33,8 +63,11 @@ bool MODPLUG_MakeInputPlugin(RAudio2_InputPlugin* plugin)
 
 bool MODPLUG_Init()
 {
+    std::lock_guard lock(modplugMutex);
+
     ModPlug_GetSettings(&modplugSettings);
     modplugSettings.mLoopCount = 1;
+    modplugSettings.mResamplingMode = RAUDIO2_MODPLUG_RESAMPLING_MODE;
     ModPlug_SetSettings(&modplugSettings);
     return true;
 }
@@ -50,24 +83,74 @@ bool MODPLUG_Open(RAudio2_WaveInfo* wave_)
     if (!file)
         return false;
 
-    auto fileSize = file.getSize();
+    // Load from the file data directly when it is already in memory
+    int64_t fileSize{};
+    auto fileData = (const unsigned char*)file.getBuffer(fileSize);
 
     std::vector<unsigned char> fileBytes;
-    fileBytes.resize((std::size_t)fileSize);
+    if (!fileData)
+    {
+        fileSize = file.getSize();
+        fileBytes.resize((std::size_t)fileSize);
+
+        file.read(fileBytes.data(), fileSize);
+        fileData = fileBytes.data();
+    }
+
+    // mix at the device rate and format to skip conversions (modplug has no float output, 32 bit is the closest)
+    auto modplugMusic = new MODPLUG_Music();
+    {
+        std::lock_guard lock(modplugMutex);
+        modplugMusic->settings = modplugSettings;
+    }
+
+    auto& settings = modplugMusic->settings;
+    settings.mFrequency = wave.getPreferredSampleRate(settings.mFrequency);
+    settings.mChannels = wave.getPreferredChannels() == 1 ? 1 : 2;
+    switch (wave.getPreferredSampleFormat())
+    {
+    case RAUDIO2_SAMPLE_FORMAT_U8: {
+        settings.mBits = 8;
+        break;
+    }
+    case RAUDIO2_SAMPLE_FORMAT_S32:
+    case RAUDIO2_SAMPLE_FORMAT_F32: {
+        settings.mBits = 32;
+        break;
+    }
+    default: {
+        settings.mBits = 16;
+        break;
+    }
+    }
 
-    file.read(fileBytes.data(), fileSize);
+    {
+        // modplug applies rate, bits and channels on load, keep the ones the loaded modules mix with
+        std::lock_guard lock(modplugMutex);
+        if (modplugLoadedCount > 0)
+        {
+            settings.mFrequency = modplugSettings.mFrequency;
+            settings.mBits = modplugSettings.mBits;
+            settings.mChannels = modplugSettings.mChannels;
+        }
 
-    auto modFile = ModPlug_Load(fileBytes.data(), (int)fileBytes.size());
-    if (!modFile)
+        modplugSettings = settings;
+        ModPlug_SetSettings(&modplugSettings);
+        modplugMusic->file = ModPlug_Load(fileData, (int)fileSize);
+        if (modplugMusic->file)
+            modplugLoadedCount++;
+    }
+    if (!modplugMusic->file)
     {
+        delete modplugMusic;
         return false;
     }
 
-    ModPlug_SetMasterVolume(modFile, modplugMasterVolume);
+    ModPlug_SetMasterVolume(modplugMusic->file, modplugMasterVolume);
 
-    wave.setCtxData(modFile);
+    wave.setCtxData(modplugMusic);
 
-    switch (modplugSettings.mBits)
+    switch (settings.mBits)
     {
     case 8: {
         wave.setSampleFormat(RAUDIO2_SAMPLE_FORMAT_U8);
@@ -82,10 +165,10 @@ bool MODPLUG_Open(RAudio2_WaveInfo* wave_)
         break;
     }
     }
-    wave.setSampleRate(modplugSettings.mFrequency);
-    wave.setChannels(modplugSettings.mChannels);
+    wave.setSampleRate(settings.mFrequency);
+    wave.setChannels(settings.mChannels);
 
-    auto numFrames = (int32_t)(((float)(ModPlug_GetLength(modFile) / 1000.f)) * (float)modplugSettings.mFrequency * (float)modplugSettings.mChannels);
+    auto numFrames = (int64_t)ModPlug_GetLength(modplugMusic->file) * (int64_t)settings.mFrequency / 1000;
     wave.setFrameCount(numFrames);
     return true;
 }
@@ -99,7 +182,11 @@ bool MODPLUG_Seek(RAudio2_WaveInfo* wave_, int64_t positionInFrames)
     if (positionInFrames <= 0)
         positionInFrames = 0;
 
-    ModPlug_Seek((ModPlugFile*)wave.getCtxData(), (int)wave.framesToMilliseconds(positionInFrames));
+    auto modplugMusic = (MODPLUG_Music*)wave.getCtxData();
+
+    std::lock_guard lock(modplugMutex);
+    MODPLUG_ApplySettings(modplugMusic->settings);
+    ModPlug_Seek(modplugMusic->file, (int)wave.framesToMilliseconds(positionInFrames));
 
     return true;
 }
@@ -127,7 +214,11 @@ int64_t MODPLUG_Read(RAudio2_WaveInfo* wave_, void* bufferOut, int64_t framesToR
     }
     }
 
-    int samplesRead = ModPlug_Read((ModPlugFile*)wave.getCtxData(), bufferOut, (int)(framesToRead * multiplier));
+    auto modplugMusic = (MODPLUG_Music*)wave.getCtxData();
+
+    std::lock_guard lock(modplugMutex);
+    MODPLUG_ApplySettings(modplugMusic->settings);
+    int samplesRead = ModPlug_Read(modplugMusic->file, bufferOut, (int)(framesToRead * multiplier));
     return samplesRead / multiplier;
 }
 
@@ -137,7 +228,13 @@ bool MODPLUG_Close(RAudio2_WaveInfo* wave_)
     if (!wave.hasValidCtxData())
         return false;
 
-    ModPlug_Unload((ModPlugFile*)wave.getCtxData());
+    auto modplugMusic = (MODPLUG_Music*)wave.getCtxData();
+    {
+        std::lock_guard lock(modplugMutex);
+        ModPlug_Unload(modplugMusic->file);
+        modplugLoadedCount--;
+    }
+    delete modplugMusic;
     wave.setCtxData(nullptr);
     return true;
 }
@@ -281,11 +378,25 @@ bool MODPLUG_GetValue(RAudio2_WaveInfo* wave_, const char* key, int32_t keyLengt
         };
         return ra::MakeArrayValue(extensions, *valueOut);
     }
+    case ra::str2int("plugin_signatures"): {
+        static const std::array<RAudio2_Signature, 25> signatures{ {
+            { 0, 17, "Extended Module: " }, { 0, 4, "IMPM" }, { 44, 4, "SCRM" }, { 1080, 4, "M.K." },
+            { 1080, 4, "M!K!" }, { 1080, 4, "FLT4" }, { 1080, 4, "4CHN" }, { 1080, 4, "6CHN" },
+            { 1080, 4, "8CHN" }, { 0, 4, "MMD0" }, { 0, 4, "MMD1" }, { 0, 4, "MMD2" },
+            { 0, 4, "MMD3" }, { 0, 4, "MT20" }, { 0, 3, "MTM" }, { 20, 8, "!Scream!" },
+            { 0, 4, "DBM0" }, { 0, 4, "FAR\xFE" }, { 0, 4, "DMDL" }, { 0, 8, "OKTASONG" },
+            { 0, 4, "PSM " }, { 44, 4, "PTMF" }, { 0, 14, "MAS_UTrack_V00" }, { 0, 4, "\xC1\x83\x2A\x9E" },
+            {}
+        } };
+        return ra::MakeArrayValue(signatures, *valueOut);
+    }
     default: {
-        auto modFile = (ModPlugFile*)wave.getCtxData();
-        if (!modFile)
+        auto modplugMusic = (MODPLUG_Music*)wave.getCtxData();
+        if (!modplugMusic)
             break;
 
+        auto modFile = modplugMusic->file;
+
         switch (keyHash)
         {
         case ra::str2int("name"):
@@ -3,6 +3,10 @@
 #include "raudio2/raudio2_config.h"
 #include "raudio2/raudio2_inputplugin.hpp"
 
+#ifndef RAUDIO2_MODPLUG_RESAMPLING_MODE
+#define RAUDIO2_MODPLUG_RESAMPLING_MODE 1 // MODPLUG_RESAMPLE_* (0 = nearest, 1 = linear, 2 = spline, 3 = FIR)
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
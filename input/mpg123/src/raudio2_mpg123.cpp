@@ -1,5 +1,6 @@
 #include "raudio2_mpg123.h"
 #include <array>
+#include <cstring>
 #include <mpg123.h>
 #include "raudio2/raudio2_common.hpp"
 #include "raudio2/raudio2_value.hpp"
@@ -23,10 +24,74 @@ bool MPG123_MakeInputPlugin(RAudio2_InputPlugin* plugin)
     plugin->read = MPG123_Read;
     plugin->close = MPG123_Close;
     plugin->getValue = MPG123_GetValue;
+    plugin->probe = MPG123_Probe;
+    plugin->readBorrow = MPG123_ReadBorrow;
 
     return true;
 }
 
+// Size of an MPEG audio frame (without padding), 0 if the header isn't valid
+static int64_t MPG123_GetFrameSize(const unsigned char* h)
+{
+    static const int32_t bitrates[2][3][15] = {
+        { { 0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256 },
+            { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 },
+            { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 } },
+        { { 0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448 },
+            { 0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384 },
+            { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320 } }
+    };
+    static const int32_t sampleRates[3] = { 44100, 48000, 32000 };
+
+    if (h[0] != 0xFF || (h[1] & 0xE0) != 0xE0)
+        return 0;
+
+    auto version = (h[1] >> 3) & 3; // 0: MPEG 2.5, 2: MPEG 2, 3: MPEG 1
+    auto layer = (h[1] >> 1) & 3;   // 1: layer 3, 2: layer 2, 3: layer 1
+    auto bitrateIndex = (h[2] >> 4) & 15;
+    auto sampleRateIndex = (h[2] >> 2) & 3;
+
+    if (version == 1 || layer == 0 || bitrateIndex == 0 || bitrateIndex == 15 || sampleRateIndex == 3)
+        return 0;
+
+    auto mpeg1 = version == 3 ? 1 : 0;
+    auto bitrate = (int64_t)bitrates[mpeg1][3 - layer][bitrateIndex] * 1000;
+    auto sampleRate = (int64_t)(sampleRates[sampleRateIndex] >> (mpeg1 ? 0 : (version == 2 ? 1 : 2)));
+
+    if (layer == 3)
+        return (12 * bitrate / sampleRate) * 4;
+    if (layer == 1 && !mpeg1)
+        return 72 * bitrate / sampleRate;
+    return 144 * bitrate / sampleRate;
+}
+
+int32_t MPG123_Probe(const void* header, int64_t headerSize)
+{
+    auto data = (const unsigned char*)header;
+
+    // raw streams start with a frame header, look for 2 consecutive frames near the start
+    for (int64_t i = 0; i < 1024 && i + 4 <= headerSize; i++)
+    {
+        auto frameSize = MPG123_GetFrameSize(data + i);
+        if (frameSize <= 0)
+            continue;
+
+        auto padding = (data[i + 2] >> 1) & 1;
+        if (padding && ((data[i + 1] >> 1) & 3) == 3)
+            padding = 4;
+
+        auto next = i + frameSize + padding;
+        if (next + 4 > headerSize)
+            return i == 0 ? 30 : 0;
+
+        if (MPG123_GetFrameSize(data + next) > 0 &&
+            ((data[i + 1] ^ data[next + 1]) & 0xFE) == 0 &&
+            ((data[i + 2] ^ data[next + 2]) & 0x0C) == 0)
+            return 75;
+    }
+    return 0;
+}
+
 static mpg123_ssize_t MPG123_OnRead(void* iohandle, void* buf, size_t size)
 {
     auto file = ra::VirtualIO((RAudio2_VirtualIO*)iohandle);
@@ -50,6 +115,12 @@ static off_t MPG123_OnSeek(void* iohandle, off_t offset, int whence)
     return file.tell();
 }
 
+struct MPG123_Music {
+    mpg123_handle* handle{ nullptr };
+    const unsigned char* frames{ nullptr }; // Decoded frames owned by mpg123, lent by MPG123_ReadBorrow
+    int64_t framesLeft{ 0 };
+};
+
 static void MPG123_Cleanup(mpg123_handle* handle)
 {
     if (handle)
@@ -111,7 +182,10 @@ bool MPG123_Open(RAudio2_WaveInfo* wave_)
         return false;
     }
 
-    wave.setCtxData(mpg123File);
+    auto music = new MPG123_Music();
+    music->handle = mpg123File;
+
+    wave.setCtxData(music);
 
     wave.setSampleFormat(RAUDIO2_SAMPLE_FORMAT_F32);
     wave.setSampleRate((int32_t)framerate);
@@ -132,15 +206,18 @@ bool MPG123_Seek(RAudio2_WaveInfo* wave, int64_t positionInFrames)
     if (!wave->ctxData)
         return false;
 
-    auto mpg123File = (mpg123_handle*)wave->ctxData;
+    auto music = (MPG123_Music*)wave->ctxData;
 
     if (positionInFrames <= 0)
         positionInFrames = 0;
 
-    return mpg123_seek(mpg123File, positionInFrames, 0) >= 0;
+    music->frames = nullptr;
+    music->framesLeft = 0;
+
+    return mpg123_seek(music->handle, positionInFrames, 0) >= 0;
 }
 
-int64_t MPG123_Read(RAudio2_WaveInfo* wave, void* bufferOut, int64_t framesToRead)
+int64_t MPG123_ReadBorrow(RAudio2_WaveInfo* wave, const void** framesOut, int64_t maxFrames)
 {
     if (!wave)
         return 0;
@@ -151,15 +228,52 @@ int64_t MPG123_Read(RAudio2_WaveInfo* wave, void* bufferOut, int64_t framesToRea
     if (!wave->ctxData)
         return 0;
 
-    auto mpg123File = (mpg123_handle*)wave->ctxData;
+    auto music = (MPG123_Music*)wave->ctxData;
+    auto frameSize = (int64_t)wave->channels * (int64_t)sizeof(float);
 
-    size_t done = 0;
-    auto bufferSize = (size_t)(framesToRead * wave->channels * 4);
+    // lend mpg123's own frame buffer instead of copying it with mpg123_read
+    while (music->framesLeft <= 0)
+    {
+        off_t frameNum{};
+        unsigned char* audio{};
+        size_t bytes{};
+
+        auto result = mpg123_decode_frame(music->handle, &frameNum, &audio, &bytes);
+        if (result == MPG123_NEW_FORMAT)
+            continue;
+        if (result != MPG123_OK)
+            return 0;
+
+        music->frames = audio;
+        music->framesLeft = (int64_t)bytes / frameSize;
+    }
 
-    if (mpg123_read(mpg123File, bufferOut, bufferSize, &done) != MPG123_OK)
-        return 0;
+    auto framesBorrowed = maxFrames < music->framesLeft ? maxFrames : music->framesLeft;
+
+    *framesOut = music->frames;
+    music->frames += framesBorrowed * frameSize;
+    music->framesLeft -= framesBorrowed;
 
-    return framesToRead;
+    return framesBorrowed;
+}
+
+int64_t MPG123_Read(RAudio2_WaveInfo* wave, void* bufferOut, int64_t framesToRead)
+{
+    auto frameSize = wave ? (int64_t)wave->channels * (int64_t)sizeof(float) : 0;
+    int64_t framesRead = 0;
+
+    while (framesRead < framesToRead)
+    {
+        const void* frames{};
+        auto framesBorrowed = MPG123_ReadBorrow(wave, &frames, framesToRead - framesRead);
+        if (framesBorrowed <= 0)
+            break;
+
+        std::memcpy((unsigned char*)bufferOut + framesRead * frameSize, frames, (size_t)(framesBorrowed * frameSize));
+        framesRead += framesBorrowed;
+    }
+
+    return framesRead;
 }
 
 bool MPG123_Close(RAudio2_WaveInfo* wave)
@@ -169,7 +283,9 @@ bool MPG123_Close(RAudio2_WaveInfo* wave)
     if (!wave->ctxData)
         return false;
 
-    MPG123_Cleanup((mpg123_handle*)wave->ctxData);
+    auto music = (MPG123_Music*)wave->ctxData;
+    MPG123_Cleanup(music->handle);
+    delete music;
     wave->ctxData = nullptr;
     return true;
 }
@@ -188,11 +304,17 @@ bool MPG123_GetValue(RAudio2_WaveInfo* wave, const char* key, int32_t keyLength,
         static const std::array<const char*, 4> extensions{ ".mp3", ".mp2", ".mp1", nullptr };
         return ra::MakeArrayValue(extensions, *valueOut);
     }
+    case ra::str2int("plugin_signatures"): {
+        static const std::array<RAudio2_Signature, 2> signatures{ { { 0, 3, "ID3" }, {} } };
+        return ra::MakeArrayValue(signatures, *valueOut);
+    }
     default: {
-        auto mpg123File = (mpg123_handle*)wave->ctxData;
-        if (!mpg123File)
+        auto music = (MPG123_Music*)wave->ctxData;
+        if (!music)
             break;
 
+        auto mpg123File = music->handle;
+
         mpg123_id3v1* tag1{};
         mpg123_id3v2* tag2{};
         mpg123_id3(mpg123File, &tag1, &tag2);
@@ -17,12 +17,16 @@ bool MPG123_Open(RAudio2_WaveInfo* wave);
 
 int64_t MPG123_Read(RAudio2_WaveInfo* wave, void* bufferOut, int64_t framesToRead);
 
+int64_t MPG123_ReadBorrow(RAudio2_WaveInfo* wave, const void** framesOut, int64_t maxFrames);
+
 bool MPG123_Seek(RAudio2_WaveInfo* wave, int64_t positionInFrames);
 
 bool MPG123_Close(RAudio2_WaveInfo* wave);
 
 bool MPG123_GetValue(RAudio2_WaveInfo* wave, const char* key, int32_t keyLength, RAudio2_Value* valueOut);
 
+int32_t MPG123_Probe(const void* header, int64_t headerSize);
+
 #ifdef __cplusplus
 }
 #endif
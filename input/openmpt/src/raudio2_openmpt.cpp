@@ -44,25 +44,41 @@ bool OPENMPT_Open(RAudio2_WaveInfo* wave_)
     if (!file)
         return false;
 
-    auto fileSize = file.getSize();
+    // Load from the file data directly when it is already in memory
+    int64_t fileSize{};
+    auto fileData = (const unsigned char*)file.getBuffer(fileSize);
 
     std::vector<unsigned char> fileBytes;
-    fileBytes.resize((std::size_t)fileSize);
+    if (!fileData)
+    {
+        fileSize = file.getSize();
+        fileBytes.resize((std::size_t)fileSize);
 
-    file.read(fileBytes.data(), fileSize);
+        file.read(fileBytes.data(), fileSize);
+        fileData = fileBytes.data();
+    }
 
-    auto modFile = openmpt_module_create_from_memory2(fileBytes.data(), fileBytes.size(),
+    auto modFile = openmpt_module_create_from_memory2(fileData, (std::size_t)fileSize,
         nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
     if (!modFile)
         return false;
 
+    // render settings belong to each module, modules render independently of each other
+    openmpt_module_set_render_param(modFile, OPENMPT_MODULE_RENDER_INTERPOLATIONFILTER_LENGTH, RAUDIO2_OPENMPT_INTERPOLATION_FILTER_LENGTH);
+
     wave.setCtxData(modFile);
 
+    // render at the device rate and channel count to skip conversions (openmpt renders mono, stereo or quad)
+    auto sampleRate = wave.getPreferredSampleRate(48000);
+    auto channels = wave.getPreferredChannels();
+    if (channels != 1 && channels != 4)
+        channels = 2;
+
     wave.setSampleFormat(RAUDIO2_SAMPLE_FORMAT_F32);
-    wave.setSampleRate(48000);
-    wave.setChannels(2);
+    wave.setSampleRate(sampleRate);
+    wave.setChannels(channels);
 
-    auto numFrames = (uint32_t)(openmpt_module_get_duration_seconds(modFile) * 48000.0);
+    auto numFrames = (int64_t)(openmpt_module_get_duration_seconds(modFile) * (double)sampleRate);
     wave.setFrameCount(numFrames);
 
     return true;
@@ -92,8 +108,15 @@ int64_t OPENMPT_Read(RAudio2_WaveInfo* wave_, void* bufferOut, int64_t framesToR
 
     auto modFile = (openmpt_module*)wave.getCtxData();
 
-    int samplesRead = openmpt_module_read_interleaved_float_stereo(modFile, wave.getSampleRate(), (size_t)framesToRead, (float*)bufferOut);
-    return samplesRead;
+    switch (wave.getChannels())
+    {
+    case 1:
+        return openmpt_module_read_float_mono(modFile, wave.getSampleRate(), (size_t)framesToRead, (float*)bufferOut);
+    case 4:
+        return openmpt_module_read_interleaved_float_quad(modFile, wave.getSampleRate(), (size_t)framesToRead, (float*)bufferOut);
+    default:
+        return openmpt_module_read_interleaved_float_stereo(modFile, wave.getSampleRate(), (size_t)framesToRead, (float*)bufferOut);
+    }
 }
 
 bool OPENMPT_Close(RAudio2_WaveInfo* wave_)
@@ -126,6 +149,18 @@ bool OPENMPT_GetValue(RAudio2_WaveInfo* wave_, const char* key, int32_t keyLengt
         };
         return ra::MakeArrayValue(extensions, *valueOut);
     }
+    case ra::str2int("plugin_signatures"): {
+        static const std::array<RAudio2_Signature, 25> signatures{ {
+            { 0, 17, "Extended Module: " }, { 0, 4, "IMPM" }, { 44, 4, "SCRM" }, { 1080, 4, "M.K." },
+            { 1080, 4, "M!K!" }, { 1080, 4, "FLT4" }, { 1080, 4, "4CHN" }, { 1080, 4, "6CHN" },
+            { 1080, 4, "8CHN" }, { 0, 4, "MMD0" }, { 0, 4, "MMD1" }, { 0, 4, "MMD2" },
+            { 0, 4, "MMD3" }, { 0, 4, "MT20" }, { 0, 3, "MTM" }, { 20, 8, "!Scream!" },
+            { 0, 4, "DBM0" }, { 0, 4, "FAR\xFE" }, { 0, 4, "DMDL" }, { 0, 8, "OKTASONG" },
+            { 0, 4, "PSM " }, { 44, 4, "PTMF" }, { 0, 14, "MAS_UTrack_V00" }, { 0, 4, "\xC1\x83\x2A\x9E" },
+            {}
+        } };
+        return ra::MakeArrayValue(signatures, *valueOut);
+    }
     default: {
         auto modFile = (openmpt_module*)wave.getCtxData();
         if (!modFile)
@@ -3,6 +3,10 @@
 #include "raudio2/raudio2_config.h"
 #include "raudio2/raudio2_inputplugin.hpp"
 
+#ifndef RAUDIO2_OPENMPT_INTERPOLATION_FILTER_LENGTH
+#define RAUDIO2_OPENMPT_INTERPOLATION_FILTER_LENGTH 0 // Interpolation taps (0 = library default, 1 = none, 2 = linear, 4 = cubic, 8 = windowed sinc)
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -2,8 +2,11 @@
 #include <algorithm>
 #include <array>
 #include <cctype>
+#include <climits>
+#include <memory>
 #include <opus/opusfile.h>
 #include "raudio2/raudio2_common.hpp"
+#include "raudio2/raudio2_sampleconv.hpp"
 #include "raudio2/raudio2_value.hpp"
 #include "raudio2/raudio2_waveinfo.hpp"
 
@@ -77,6 +80,20 @@ static opus_int64 OPUS_OnTell(void* stream)
 
 static OpusFileCallbacks ofCallbacks;
 
+struct OPUS_Music
+{
+    OggOpusFile* file{};
+    bool floatOutput{ false };
+    bool stereoDownmix{ false };
+    const int32_t* channelOrder{};
+
+    ~OPUS_Music()
+    {
+        if (file)
+            op_free(file);
+    }
+};
+
 bool OPUS_Init()
 {
     ofCallbacks.read = OPUS_OnRead;
@@ -97,27 +114,49 @@ bool OPUS_Open(RAudio2_WaveInfo* wave_)
     if (!file)
         return false;
 
+    auto opusMusic = std::make_unique<OPUS_Music>();
+    if (!opusMusic)
+        return false;
+
     int error{};
-    auto opusFile = op_open_callbacks(file.getVirtualIO(), &ofCallbacks, nullptr, 0, &error);
-    if (!opusFile)
+    opusMusic->file = op_open_callbacks(file.getVirtualIO(), &ofCallbacks, nullptr, 0, &error);
+    if (!opusMusic->file)
         return false;
 
-    if (opusFile)
-    {
-        wave.setCtxData(opusFile);
+    auto opusFile = opusMusic->file;
 
-        wave.setSampleFormat(RAUDIO2_SAMPLE_FORMAT_S16);
-        wave.setSampleRate(48000);
+    // opus decodes to float natively, skip the s16 round trip if the device mixes in float
+    opusMusic->floatOutput = wave.getPreferredSampleFormat() == RAUDIO2_SAMPLE_FORMAT_F32;
 
-        //auto info = op_head(opusFile, -1);
-        //wave.setChannels((int32_t)info->channel_count);
-        wave.setChannels(2);
+    wave.setSampleFormat(opusMusic->floatOutput ? RAUDIO2_SAMPLE_FORMAT_F32 : RAUDIO2_SAMPLE_FORMAT_S16);
+    wave.setSampleRate(48000);
+
+    // Keep the native channels, unless chained links change the channel layout midway
+    auto head = op_head(opusFile, 0);
+    for (int link = 1; link < op_link_count(opusFile) && !opusMusic->stereoDownmix; link++)
+    {
+        auto linkHead = op_head(opusFile, link);
+        opusMusic->stereoDownmix = linkHead->channel_count != head->channel_count || linkHead->mapping_family != head->mapping_family;
+    }
 
-        wave.setFrameCount(op_pcm_total(opusFile, -1));
+    if (opusMusic->stereoDownmix)
+    {
+        wave.setChannels(2);
+    }
+    else
+    {
+        wave.setChannels(head->channel_count);
 
-        return true;
+        // Mapping family 1 uses the vorbis channel order
+        if (head->mapping_family == 1)
+            opusMusic->channelOrder = ra::getVorbisChannelOrder(head->channel_count);
     }
-    return false;
+
+    wave.setFrameCount(op_pcm_total(opusFile, -1));
+
+    wave.setCtxData(opusMusic.release());
+
+    return true;
 }
 
 bool OPUS_Seek(RAudio2_WaveInfo* wave, int64_t positionInFrames)
@@ -131,12 +170,12 @@ bool OPUS_Seek(RAudio2_WaveInfo* wave, int64_t positionInFrames)
     if (!wave->ctxData)
         return false;
 
-    auto opusFile = (OggOpusFile*)wave->ctxData;
+    auto music = (OPUS_Music*)wave->ctxData;
 
     if (positionInFrames <= 0)
         positionInFrames = 0;
 
-    return op_pcm_seek(opusFile, positionInFrames) == 0;
+    return op_pcm_seek(music->file, positionInFrames) == 0;
     return false;
 }
 
@@ -151,33 +190,50 @@ int64_t OPUS_Read(RAudio2_WaveInfo* wave, void* bufferOut, int64_t framesToRead)
     if (!wave->ctxData)
         return 0;
 
-    auto opusFile = (OggOpusFile*)wave->ctxData;
+    auto music = (OPUS_Music*)wave->ctxData;
 
-    auto numBytes = (int)(framesToRead * wave->channels * 2);
-    int totalBytesRead{};
+    auto frameSize = (int64_t)wave->channels * (music->floatOutput ? (int64_t)sizeof(float) : (int64_t)sizeof(opus_int16));
+    int64_t framesRead = 0;
 
-    while (numBytes >= wave->channels * 2)
+    while (framesRead < framesToRead)
     {
-        auto samplesRead = op_read_stereo(opusFile, (opus_int16*)bufferOut, numBytes / 2);
+        auto bufferPtr = (unsigned char*)bufferOut + framesRead * frameSize;
+        auto bufferSize = (int)std::min((framesToRead - framesRead) * wave->channels, (int64_t)INT_MAX);
 
-        if (samplesRead == OP_HOLE)
+        int samplesRead{};
+        int link{};
+        if (music->stereoDownmix)
         {
-            continue;
+            samplesRead = music->floatOutput ? op_read_float_stereo(music->file, (float*)bufferPtr, bufferSize)
+                                             : op_read_stereo(music->file, (opus_int16*)bufferPtr, bufferSize);
         }
-        else if (samplesRead <= 0)
+        else
         {
-            break;
+            samplesRead = music->floatOutput ? op_read_float(music->file, (float*)bufferPtr, bufferSize, &link)
+                                             : op_read(music->file, (opus_int16*)bufferPtr, bufferSize, &link);
         }
-        else
+
+        if (samplesRead == OP_HOLE)
+            continue;
+        else if (samplesRead <= 0)
+            break;
+
+        // Links of unseekable streams aren't known at open, one changing the channel count ends the stream
+        if (!music->stereoDownmix && op_head(music->file, link)->channel_count != wave->channels)
+            break;
+
+        if (music->channelOrder)
         {
-            auto bytesRead = samplesRead * wave->channels * 2;
-            totalBytesRead += bytesRead;
-            bufferOut = (void*)((unsigned char*)bufferOut + bytesRead);
-            numBytes -= bytesRead;
+            if (music->floatOutput)
+                ra::reorderInterleavedChannels((float*)bufferPtr, wave->channels, samplesRead, music->channelOrder);
+            else
+                ra::reorderInterleavedChannels((opus_int16*)bufferPtr, wave->channels, samplesRead, music->channelOrder);
         }
+
+        framesRead += samplesRead;
     }
 
-    return (uint64_t)(totalBytesRead / (wave->channels * 2));
+    return framesRead;
 }
 
 bool OPUS_Close(RAudio2_WaveInfo* wave)
@@ -187,9 +243,9 @@ bool OPUS_Close(RAudio2_WaveInfo* wave)
     if (!wave->ctxData)
         return false;
 
-    auto opusFile = (OggOpusFile*)wave->ctxData;
+    auto music = (OPUS_Music*)wave->ctxData;
 
-    op_free(opusFile);
+    delete music;
     wave->ctxData = nullptr;
     return true;
 }
@@ -237,11 +293,17 @@ bool OPUS_GetValue(RAudio2_WaveInfo* wave, const char* key, int32_t keyLength, R
         static const std::array<const char*, 3> extensions{ ".opus", ".ogg", nullptr };
         return ra::MakeArrayValue(extensions, *valueOut);
     }
+    case ra::str2int("plugin_signatures"): {
+        static const std::array<RAudio2_Signature, 2> signatures{ { { 28, 8, "OpusHead" }, {} } };
+        return ra::MakeArrayValue(signatures, *valueOut);
+    }
     default: {
-        auto opusFile = (OggOpusFile*)wave->ctxData;
-        if (!opusFile)
+        auto music = (OPUS_Music*)wave->ctxData;
+        if (!music)
             break;
 
+        auto opusFile = music->file;
+
         auto tags = op_tags(opusFile, -1);
 
         constexpr auto vobTagArtist = "artist="sv;
@@ -0,0 +1,393 @@
+#include "raudio2_qoa.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include "raudio2/raudio2_common.hpp"
+#include "raudio2/raudio2_value.hpp"
+#include "raudio2/raudio2_waveinfo.hpp"
+#include <vector>
+
+using namespace std::literals;
+
+// QOA file layout (all values big endian):
+// file header: "qoaf", samples per channel (u32, 0 for streams of unknown length)
+// frame header: channels (u8), sample rate (u24), samples per channel (u16), frame size in bytes (u16)
+// then the LMS state of each channel (4 history and 4 weight s16 values)
+// then up to 256 slices of 20 samples per channel, interleaved by channel
+// Every frame but the last holds 5120 samples per channel, so frames sit at fixed offsets
+static constexpr int64_t QOA_FileHeaderSize = 8;
+static constexpr int64_t QOA_FrameHeaderSize = 8;
+static constexpr int64_t QOA_LMSStateSize = 16;
+static constexpr int64_t QOA_SliceSize = 8;
+static constexpr int32_t QOA_SliceLength = 20;
+static constexpr int32_t QOA_SlicesPerFrame = 256;
+static constexpr int32_t QOA_FrameLength = QOA_SliceLength * QOA_SlicesPerFrame;
+static constexpr int32_t QOA_MaxChannels = 8;
+
+#ifdef RAUDIO2_STANDALONE_PLUGIN
+bool RAudio2_GetInputPlugin(RAudio2_InputPlugin* plugin)
+{
+    return QOA_MakeInputPlugin(plugin);
+}
+#endif
+
+bool QOA_MakeInputPlugin(RAudio2_InputPlugin* plugin)
+{
+    plugin->flags = 0;
+    plugin->open = QOA_Open;
+    plugin->seek = QOA_Seek;
+    plugin->read = QOA_Read;
+    plugin->readBorrow = QOA_ReadBorrow;
+    plugin->close = QOA_Close;
+    plugin->getValue = QOA_GetValue;
+
+    return true;
+}
+
+struct QOA_Music
+{
+    const unsigned char* fileData{ nullptr }; // Whole file when it is in memory, frames are decoded from it directly
+    std::vector<unsigned char> frameBytes;    // Frame read from the file otherwise
+    int64_t fileSize{};
+    int64_t readOffset{ -1 }; // File offset after the last frame read, skips seeking when reading in order
+
+    int32_t channels{};
+    int32_t sampleRate{};
+    int64_t frameCount{};    // Total samples per channel
+    int64_t maxFrameSize{};  // Size of a full frame in bytes
+    int64_t frameIndex{};    // Next frame to decode
+
+    std::vector<int16_t> output; // Last decoded frame, interleaved
+    int32_t outputOffset{};
+    int32_t outputFrames{};
+};
+
+static uint64_t QOA_ReadU64(const unsigned char* bytes)
+{
+    uint64_t value = 0;
+    for (int32_t i = 0; i < 8; i++)
+        value = (value << 8) | bytes[i];
+    return value;
+}
+
+// Decodes one frame into interleaved s16 samples, returns the samples per channel (0 on error)
+// The LMS state and slices of all channels are kept in arrays indexed by channel,
+// so the innermost loop runs the same steps on independent channels and vectorizes
+static int32_t QOA_DecodeFrame(const unsigned char* bytes, int64_t size, int32_t channels, int32_t sampleRate, int16_t* samplesOut)
+{
+    if (size < QOA_FrameHeaderSize + channels * QOA_LMSStateSize)
+        return 0;
+
+    auto header = QOA_ReadU64(bytes);
+    auto frameChannels = (int32_t)(header >> 56);
+    auto frameSampleRate = (int32_t)((header >> 32) & 0xFFFFFF);
+    auto frameSamples = (int32_t)((header >> 16) & 0xFFFF);
+    auto frameSize = (int64_t)(header & 0xFFFF);
+
+    // Streams may change their layout between frames, the audio stream can't follow
+    if (frameChannels != channels || frameSampleRate != sampleRate || frameSamples > QOA_FrameLength)
+        return 0;
+
+    auto slices = (frameSamples + QOA_SliceLength - 1) / QOA_SliceLength;
+    if (frameSize > size || frameSize < QOA_FrameHeaderSize + channels * (QOA_LMSStateSize + slices * QOA_SliceSize))
+        return 0;
+
+    std::array<std::array<int32_t, QOA_MaxChannels>, 4> history{};
+    std::array<std::array<int32_t, QOA_MaxChannels>, 4> weights{};
+    std::array<std::array<int32_t, QOA_MaxChannels>, QOA_SliceLength> residuals{};
+
+    auto in = bytes + QOA_FrameHeaderSize;
+    for (int32_t channel = 0; channel < channels; channel++, in += QOA_LMSStateSize)
+    {
+        auto historyBits = QOA_ReadU64(in);
+        auto weightBits = QOA_ReadU64(in + 8);
+        for (int32_t i = 0; i < 4; i++, historyBits <<= 16, weightBits <<= 16)
+        {
+            history[i][channel] = (int16_t)(historyBits >> 48);
+            weights[i][channel] = (int16_t)(weightBits >> 48);
+        }
+    }
+
+    // Scale factors are round(s^2.75) for s = 1 to 16
+    static constexpr std::array<int32_t, 16> scaleFactors{
+        1, 7, 21, 45, 84, 138, 211, 304, 421, 562, 731, 928, 1157, 1419, 1715, 2048
+    };
+
+    for (int32_t sliceStart = 0; sliceStart < frameSamples; sliceStart += QOA_SliceLength)
+    {
+        // Residuals dequantize to scaleFactor * (0.75, 2.5, 4.5, 7) rounded away from zero, odd codes are negative
+        for (int32_t channel = 0; channel < channels; channel++, in += QOA_SliceSize)
+        {
+            auto sliceBits = QOA_ReadU64(in);
+            auto scaleFactor = scaleFactors[sliceBits >> 60];
+            const std::array<int32_t, 4> magnitudes{
+                (scaleFactor * 3 + 2) >> 2, (scaleFactor * 10 + 2) >> 2, (scaleFactor * 18 + 2) >> 2, scaleFactor * 7
+            };
+            for (int32_t sample = 0; sample < QOA_SliceLength; sample++)
+            {
+                auto quantized = (int32_t)(sliceBits >> (57 - sample * 3)) & 7;
+                residuals[sample][channel] = (quantized & 1) ? -magnitudes[quantized >> 1] : magnitudes[quantized >> 1];
+            }
+        }
+
+        auto sliceEnd = std::min(sliceStart + QOA_SliceLength, frameSamples);
+        for (int32_t sample = sliceStart; sample < sliceEnd; sample++)
+        {
+            const auto& residual = residuals[sample - sliceStart];
+            auto out = samplesOut + (int64_t)sample * channels;
+            for (int32_t channel = 0; channel < channels; channel++)
+            {
+                auto predicted = (history[0][channel] * weights[0][channel] + history[1][channel] * weights[1][channel] +
+                                  history[2][channel] * weights[2][channel] + history[3][channel] * weights[3][channel]) >> 13;
+                auto reconstructed = std::clamp(predicted + residual[channel], -32768, 32767);
+
+                auto delta = residual[channel] >> 4;
+                weights[0][channel] += history[0][channel] < 0 ? -delta : delta;
+                weights[1][channel] += history[1][channel] < 0 ? -delta : delta;
+                weights[2][channel] += history[2][channel] < 0 ? -delta : delta;
+                weights[3][channel] += history[3][channel] < 0 ? -delta : delta;
+
+                history[0][channel] = history[1][channel];
+                history[1][channel] = history[2][channel];
+                history[2][channel] = history[3][channel];
+                history[3][channel] = reconstructed;
+
+                out[channel] = (int16_t)reconstructed;
+            }
+        }
+    }
+
+    return frameSamples;
+}
+
+// Points bytesOut at the frame starting at offset, reading it from the file if it isn't in memory
+static int64_t QOA_GetFrameBytes(QOA_Music& music, ra::VirtualIO& file, int64_t offset, const unsigned char*& bytesOut)
+{
+    auto size = std::min(music.maxFrameSize, music.fileSize - offset);
+    if (size <= 0)
+        return 0;
+
+    if (music.fileData)
+    {
+        bytesOut = music.fileData + offset;
+        return size;
+    }
+
+    if (offset != music.readOffset && file.seek(offset, RAUDIO2_SEEK_SET) < 0)
+        return 0;
+
+    music.frameBytes.resize((size_t)size);
+    size = std::max(file.read(music.frameBytes.data(), size), (int64_t)0);
+    music.readOffset = offset + size;
+
+    bytesOut = music.frameBytes.data();
+    return size;
+}
+
+static bool QOA_DecodeNextFrame(QOA_Music& music, ra::VirtualIO& file)
+{
+    auto firstFrame = music.frameIndex * QOA_FrameLength;
+    if (firstFrame >= music.frameCount)
+        return false;
+
+    const unsigned char* bytes{};
+    auto size = QOA_GetFrameBytes(music, file, QOA_FileHeaderSize + music.frameIndex * music.maxFrameSize, bytes);
+
+    auto frames = QOA_DecodeFrame(bytes, size, music.channels, music.sampleRate, music.output.data());
+    if (frames <= 0)
+        return false;
+
+    music.frameIndex++;
+    music.outputOffset = 0;
+    music.outputFrames = (int32_t)std::min((int64_t)frames, music.frameCount - firstFrame);
+    return true;
+}
+
+bool QOA_Open(RAudio2_WaveInfo* wave_)
+{
+    ra::WaveInfo wave = wave_;
+    if (!wave.hasValidWave())
+        return false;
+
+    auto file = wave.getFile();
+
+    if (!file)
+        return false;
+
+    std::array<unsigned char, QOA_FileHeaderSize + QOA_FrameHeaderSize> header{};
+    if (file.read(header.data(), (int64_t)header.size()) != (int64_t)header.size())
+        return false;
+    if (std::memcmp(header.data(), "qoaf", 4) != 0)
+        return false;
+
+    auto fileHeader = QOA_ReadU64(header.data());
+    auto frameHeader = QOA_ReadU64(header.data() + QOA_FileHeaderSize);
+
+    auto channels = (int32_t)(frameHeader >> 56);
+    auto sampleRate = (int32_t)((frameHeader >> 32) & 0xFFFFFF);
+    if (channels < 1 || channels > QOA_MaxChannels || sampleRate <= 0)
+        return false;
+
+    auto music = new QOA_Music();
+    music->channels = channels;
+    music->sampleRate = sampleRate;
+    music->maxFrameSize = QOA_FrameHeaderSize + channels * (QOA_LMSStateSize + QOA_SlicesPerFrame * QOA_SliceSize);
+    music->fileData = (const unsigned char*)file.getBuffer(music->fileSize);
+    if (!music->fileData)
+        music->fileSize = file.getSize();
+    music->frameCount = (int64_t)(fileHeader & 0xFFFFFFFF);
+
+    // Streams don't store their length, only the last frame can be shorter than the others
+    if (music->frameCount == 0 && music->fileSize > QOA_FileHeaderSize)
+    {
+        auto lastFrameIndex = (music->fileSize - QOA_FileHeaderSize - 1) / music->maxFrameSize;
+
+        const unsigned char* bytes{};
+        if (QOA_GetFrameBytes(*music, file, QOA_FileHeaderSize + lastFrameIndex * music->maxFrameSize, bytes) >= QOA_FrameHeaderSize)
+            music->frameCount = lastFrameIndex * QOA_FrameLength + (int64_t)((QOA_ReadU64(bytes) >> 16) & 0xFFFF);
+    }
+
+    if (music->frameCount <= 0)
+    {
+        delete music;
+        return false;
+    }
+
+    music->output.resize((size_t)QOA_FrameLength * channels);
+
+    wave.setCtxData(music);
+
+    wave.setSampleFormat(RAUDIO2_SAMPLE_FORMAT_S16);
+    wave.setSampleRate(sampleRate);
+    wave.setChannels(channels);
+    wave.setFrameCount(music->frameCount);
+    return true;
+}
+
+bool QOA_Seek(RAudio2_WaveInfo* wave_, int64_t positionInFrames)
+{
+    ra::WaveInfo wave = wave_;
+    if (!wave)
+        return false;
+
+    auto music = (QOA_Music*)wave.getCtxData();
+    auto file = wave.getFile();
+
+    positionInFrames = std::clamp(positionInFrames, (int64_t)0, music->frameCount);
+
+    // Frames carry their own LMS state, decoding starts at the frame holding the position
+    music->frameIndex = positionInFrames / QOA_FrameLength;
+    music->outputOffset = 0;
+    music->outputFrames = 0;
+
+    if (positionInFrames == music->frameCount)
+        return true;
+
+    if (!QOA_DecodeNextFrame(*music, file))
+        return false;
+
+    music->outputOffset = (int32_t)(positionInFrames % QOA_FrameLength);
+    return true;
+}
+
+int64_t QOA_ReadBorrow(RAudio2_WaveInfo* wave_, const void** framesOut, int64_t maxFrames)
+{
+    ra::WaveInfo wave = wave_;
+    if (!wave)
+        return 0;
+
+    auto music = (QOA_Music*)wave.getCtxData();
+    auto file = wave.getFile();
+
+    if (music->outputOffset >= music->outputFrames && !QOA_DecodeNextFrame(*music, file))
+        return 0;
+
+    auto framesBorrowed = std::min(maxFrames, (int64_t)(music->outputFrames - music->outputOffset));
+    if (framesBorrowed <= 0)
+        return 0;
+
+    *framesOut = music->output.data() + (int64_t)music->outputOffset * music->channels;
+    music->outputOffset += (int32_t)framesBorrowed;
+
+    return framesBorrowed;
+}
+
+int64_t QOA_Read(RAudio2_WaveInfo* wave_, void* bufferOut, int64_t framesToRead)
+{
+    ra::WaveInfo wave = wave_;
+    if (!wave)
+        return 0;
+
+    auto music = (QOA_Music*)wave.getCtxData();
+    auto frameSize = (int64_t)music->channels * (int64_t)sizeof(int16_t);
+
+    int64_t framesRead = 0;
+    while (framesRead < framesToRead)
+    {
+        const void* frames{};
+        auto framesBorrowed = QOA_ReadBorrow(wave_, &frames, framesToRead - framesRead);
+        if (framesBorrowed <= 0)
+            break;
+
+        std::memcpy((unsigned char*)bufferOut + framesRead * frameSize, frames, (size_t)(framesBorrowed * frameSize));
+        framesRead += framesBorrowed;
+    }
+
+    return framesRead;
+}
+
+bool QOA_Close(RAudio2_WaveInfo* wave_)
+{
+    ra::WaveInfo wave = wave_;
+    if (!wave.hasValidCtxData())
+        return false;
+
+    delete (QOA_Music*)wave.getCtxData();
+    wave.setCtxData(nullptr);
+    return true;
+}
+
+bool QOA_GetValue(RAudio2_WaveInfo* wave_, const char* key, int32_t keyLength, RAudio2_Value* valueOut)
+{
+    ra::WaveInfo wave = wave_;
+
+    // only process keys with less than 32 chars
+    auto keyHash = ra::str2int(std::string_view(key, keyLength).substr(0, 32));
+    switch (keyHash)
+    {
+    case ra::str2int("plugin_name"): {
+        return ra::MakeValue("qoa"sv, *valueOut);
+    }
+    case ra::str2int("plugin_extensions"): {
+        static const std::array<const char*, 2> extensions{ ".qoa", nullptr };
+        return ra::MakeArrayValue(extensions, *valueOut);
+    }
+    case ra::str2int("plugin_signatures"): {
+        static const std::array<RAudio2_Signature, 2> signatures{ {
+            { 0, 4, "qoaf" }, {}
+        } };
+        return ra::MakeArrayValue(signatures, *valueOut);
+    }
+    default: {
+        auto music = (QOA_Music*)wave.getCtxData();
+        if (!music)
+            break;
+
+        switch (keyHash)
+        {
+        case ra::str2int("bps"):
+        case ra::str2int("current_bps"): {
+            auto val = music->fileSize * 8 * music->sampleRate / music->frameCount;
+            return ra::MakeValue(val, *valueOut);
+        }
+        case ra::str2int("format"): {
+            return ra::MakeValue("QOA"sv, *valueOut);
+        }
+        default:
+            break;
+        }
+    }
+    }
+    *valueOut = {};
+    return false;
+}
@@ -318,6 +318,14 @@ bool SNDFILE_GetValue(RAudio2_WaveInfo* wave, const char* key, int32_t keyLength
         };
         return ra::MakeArrayValue(extensions, *valueOut);
     }
+    case ra::str2int("plugin_signatures"): {
+        static const std::array<RAudio2_Signature, 9> signatures{ {
+            { 0, 4, "RIFF" }, { 0, 4, "RIFX" }, { 0, 4, "RF64" },
+            { 0, 4, "FORM" }, { 0, 4, "fLaC" }, { 0, 4, "OggS" },
+            { 0, 4, "caff" }, { 0, 4, ".snd" }, {}
+        } };
+        return ra::MakeArrayValue(signatures, *valueOut);
+    }
     default: {
         auto sndMusic = (SNDFILE_Music*)wave->ctxData;
         if (!sndMusic || !sndMusic->file)
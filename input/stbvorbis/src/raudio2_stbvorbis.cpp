@@ -1,8 +1,13 @@
 #include "raudio2_stbvorbis.h"
+#include <algorithm>
 #include <array>
+#include <climits>
+#include <cstring>
 #include <memory>
 #include "raudio2/raudio2_common.hpp"
+#include "raudio2/raudio2_sampleconv.hpp"
 #include "raudio2/raudio2_value.hpp"
+#include "raudio2/raudio2_virtualio.hpp"
 #include "raudio2/raudio2_waveinfo.hpp"
 #include <vector>
 
@@ -32,10 +37,336 @@ bool STBVORBIS_MakeInputPlugin(RAudio2_InputPlugin* plugin)
 }
 
 struct STBVORBIS_Music {
-    stb_vorbis* file{ nullptr };
-    std::vector<unsigned char> fileBytes;
+    ra::VirtualIO file;
+    stb_vorbis* vorbis{ nullptr };
+    stb_vorbis startState{};                  // Decoder state after the headers, restored to seek back to the start
+    const unsigned char* fileData{ nullptr }; // Whole file when it is already in memory, decoded in place
+    int64_t fileSize{};
+    int64_t audioOffset{};                    // File offset of the first audio packet
+    int64_t readOffset{};                     // File offset of the next byte handed to the decoder
+    std::vector<unsigned char> buffer;        // Rolling window of the file when it isn't in memory
+    int64_t bufferFileOffset{};               // File offset of the first byte in the buffer
+    int64_t bufferStart{};                    // Unused data in the buffer
+    int64_t bufferEnd{};
+    float** output{ nullptr };                // Last decoded frame, owned by stb_vorbis
+    int32_t outputOffset{};
+    int32_t outputFrames{};
+    int64_t position{};                       // Frame of the next output sample
+    int64_t frameCount{};
+    int32_t channels{};
+    bool floatOutput{ false };
+    const int32_t* channelOrder{};
+
+    STBVORBIS_Music(const ra::VirtualIO& file_) noexcept : file(file_) {}
+
+    ~STBVORBIS_Music()
+    {
+        if (vorbis)
+            stb_vorbis_close(vorbis);
+    }
 };
 
+// Ogg page fields used to seek
+struct STBVORBIS_Page {
+    int64_t offset{};
+    int64_t size{};
+    int64_t granulePosition{ -1 };
+    int32_t firstPacketStart{ -1 }; // First two bytes of the first packet, -1 if the page continues a packet
+    int32_t lastPacketStart{ -1 };  // First two bytes of the last packet starting and ending on the page, -1 if none
+};
+
+static const unsigned char* STBVORBIS_GetInput(STBVORBIS_Music& music, int& sizeOut)
+{
+    if (music.fileData)
+    {
+        sizeOut = (int)std::min(music.fileSize - music.readOffset, (int64_t)INT_MAX);
+        return music.fileData + music.readOffset;
+    }
+
+    sizeOut = (int)(music.bufferEnd - music.bufferStart);
+    return music.buffer.data() + music.bufferStart;
+}
+
+static void STBVORBIS_ConsumeInput(STBVORBIS_Music& music, int count)
+{
+    music.readOffset += count;
+    if (!music.fileData)
+        music.bufferStart += count;
+}
+
+static void STBVORBIS_SetInputOffset(STBVORBIS_Music& music, int64_t offset)
+{
+    music.readOffset = offset;
+    music.bufferFileOffset = offset;
+    music.bufferStart = 0;
+    music.bufferEnd = 0;
+}
+
+// Moves the unused data to the front of the buffer and reads more of the file after it
+// The buffer only grows when a single packet doesn't fit
+// Returns false if no data could be added
+static bool STBVORBIS_RefillInput(STBVORBIS_Music& music)
+{
+    if (music.fileData)
+        return false;
+
+    if (music.bufferStart > 0)
+    {
+        auto unusedSize = music.bufferEnd - music.bufferStart;
+        std::memmove(music.buffer.data(), music.buffer.data() + music.bufferStart, (size_t)unusedSize);
+        music.bufferFileOffset += music.bufferStart;
+        music.bufferStart = 0;
+        music.bufferEnd = unusedSize;
+    }
+    else if (music.bufferEnd == (int64_t)music.buffer.size())
+    {
+        if (music.buffer.size() > INT_MAX / 2)
+            return false;
+        music.buffer.resize(music.buffer.size() * 2);
+    }
+
+    music.file.seek(music.bufferFileOffset + music.bufferEnd);
+    auto bytesRead = music.file.read(music.buffer.data() + music.bufferEnd, (int64_t)music.buffer.size() - music.bufferEnd);
+    if (bytesRead <= 0)
+        return false;
+
+    music.bufferEnd += bytesRead;
+    return true;
+}
+
+// Decodes the next frame with output into music.output
+static bool STBVORBIS_DecodeFrame(STBVORBIS_Music& music)
+{
+    for (;;)
+    {
+        int inputSize{};
+        auto input = STBVORBIS_GetInput(music, inputSize);
+
+        float** output{};
+        int samples{};
+        auto bytesUsed = stb_vorbis_decode_frame_pushdata(music.vorbis, input, inputSize, nullptr, &output, &samples);
+        STBVORBIS_ConsumeInput(music, bytesUsed);
+
+        if (samples > 0)
+        {
+            music.output = output;
+            music.outputOffset = 0;
+            music.outputFrames = samples;
+            return true;
+        }
+
+        // No bytes used means the next packet isn't complete yet
+        if (bytesUsed == 0 && !STBVORBIS_RefillInput(music))
+            return false;
+    }
+}
+
+static int64_t STBVORBIS_ReadAt(STBVORBIS_Music& music, int64_t offset, void* bufferOut, int64_t size)
+{
+    if (offset < 0 || offset >= music.fileSize)
+        return 0;
+
+    size = std::min(size, music.fileSize - offset);
+    if (music.fileData)
+    {
+        std::memcpy(bufferOut, music.fileData + offset, (size_t)size);
+        return size;
+    }
+
+    music.file.seek(offset);
+    return music.file.read(bufferOut, size);
+}
+
+// Reads the ogg page at offset, false if there isn't a page with a valid checksum there
+static bool STBVORBIS_ReadPage(STBVORBIS_Music& music, int64_t offset, STBVORBIS_Page& pageOut, std::vector<unsigned char>& pageBytes)
+{
+    constexpr int64_t pageHeaderSize = 27;
+
+    std::array<unsigned char, pageHeaderSize + 255> header{};
+    auto headerRead = STBVORBIS_ReadAt(music, offset, header.data(), (int64_t)header.size());
+    if (headerRead < pageHeaderSize || std::memcmp(header.data(), ogg_page_header, 4) != 0 || header[4] != 0)
+        return false;
+
+    const int32_t segmentCount = header[26];
+    const int64_t headerSize = pageHeaderSize + segmentCount;
+    if (headerRead < headerSize)
+        return false;
+
+    auto pageSize = headerSize;
+    for (int32_t i = 0; i < segmentCount; i++)
+        pageSize += header[pageHeaderSize + i];
+
+    pageBytes.resize((size_t)pageSize);
+    if (STBVORBIS_ReadAt(music, offset, pageBytes.data(), pageSize) != pageSize)
+        return false;
+
+    // The checksum is computed with its own field set to 0
+    uint32 crc = 0;
+    for (int64_t i = 0; i < pageSize; i++)
+        crc = crc32_update(crc, (i >= 22 && i < 26) ? 0 : pageBytes[(size_t)i]);
+    if (crc != (uint32)(pageBytes[22] | (pageBytes[23] << 8) | (pageBytes[24] << 16) | ((uint32)pageBytes[25] << 24)))
+        return false;
+
+    pageOut.offset = offset;
+    pageOut.size = pageSize;
+    pageOut.granulePosition = 0;
+    for (int32_t i = 7; i >= 0; i--)
+        pageOut.granulePosition = (int64_t)(((uint64_t)pageOut.granulePosition << 8) | pageBytes[6 + i]);
+
+    // Packets are identified by their first two bytes, enough for the mode and window flags
+    auto getPacketStart = [&](int64_t packetOffset, int64_t packetEnd) {
+        auto packetStart = (int32_t)pageBytes[(size_t)packetOffset];
+        if (packetEnd - packetOffset > 1)
+            packetStart |= pageBytes[(size_t)packetOffset + 1] << 8;
+        return packetStart;
+    };
+
+    const bool continued = (pageBytes[5] & PAGEFLAG_continued_packet) != 0;
+    pageOut.firstPacketStart = (!continued && pageSize > headerSize) ? getPacketStart(headerSize, pageSize) : -1;
+    pageOut.lastPacketStart = -1;
+
+    auto packetStart = headerSize;
+    auto packetStartsOnPage = !continued;
+    auto packetEnd = headerSize;
+    for (int32_t i = 0; i < segmentCount; i++)
+    {
+        packetEnd += header[pageHeaderSize + i];
+        if (header[pageHeaderSize + i] == 255)
+            continue;
+
+        pageOut.lastPacketStart = (packetStartsOnPage && packetEnd > packetStart) ? getPacketStart(packetStart, packetEnd) : -1;
+        packetStart = packetEnd;
+        packetStartsOnPage = true;
+    }
+    // The last packet continues on the next page
+    if (segmentCount > 0 && header[pageHeaderSize + segmentCount - 1] == 255)
+        pageOut.lastPacketStart = -1;
+
+    return true;
+}
+
+// Finds the first valid page starting between offset and endOffset
+static bool STBVORBIS_FindPage(STBVORBIS_Music& music, int64_t offset, int64_t endOffset, STBVORBIS_Page& pageOut, std::vector<unsigned char>& pageBytes)
+{
+    std::array<unsigned char, 4096> chunk{};
+    while (offset < endOffset)
+    {
+        auto bytesRead = STBVORBIS_ReadAt(music, offset, chunk.data(), std::min((int64_t)chunk.size(), endOffset - offset + 3));
+        if (bytesRead < 4)
+            return false;
+
+        for (int64_t i = 0; i + 4 <= bytesRead && offset + i < endOffset; i++)
+        {
+            if (chunk[(size_t)i] == ogg_page_header[0] && std::memcmp(chunk.data() + i, ogg_page_header, 4) == 0 &&
+                STBVORBIS_ReadPage(music, offset + i, pageOut, pageBytes))
+                return true;
+        }
+        offset += bytesRead - 3;
+    }
+    return false;
+}
+
+// The granule position of the last page is the length of the stream, search for it from the end of the file
+static int64_t STBVORBIS_GetStreamLength(STBVORBIS_Music& music)
+{
+    std::vector<unsigned char> pageBytes;
+    for (int64_t tailSize = 65536;; tailSize *= 2)
+    {
+        auto tailOffset = std::max(music.audioOffset, music.fileSize - tailSize);
+
+        int64_t granulePosition = -1;
+        STBVORBIS_Page page;
+        for (auto found = STBVORBIS_FindPage(music, tailOffset, music.fileSize, page, pageBytes); found;
+             found = STBVORBIS_ReadPage(music, page.offset + page.size, page, pageBytes))
+        {
+            if (page.granulePosition >= 0)
+                granulePosition = page.granulePosition;
+        }
+
+        if (granulePosition >= 0 || tailOffset == music.audioOffset)
+            return granulePosition;
+    }
+}
+
+// Window of the audio packet starting with packetStart, false if it isn't an audio packet
+// rightStartOut is where the window starts overlapping the next block, the end of the frames stb_vorbis returns for it
+static bool STBVORBIS_GetPacketWindow(const stb_vorbis* vorbis, int32_t packetStart, int32_t& blockSizeOut, int32_t& rightStartOut)
+{
+    if (packetStart < 0 || (packetStart & 1) != 0)
+        return false;
+
+    const auto modeBits = ilog(vorbis->mode_count - 1);
+    const auto mode = (packetStart >> 1) & ((1 << modeBits) - 1);
+    if (mode >= vorbis->mode_count)
+        return false;
+
+    // Long blocks store whether the next block is long too
+    const auto longBlock = vorbis->mode_config[mode].blockflag != 0;
+    const auto nextLongBlock = longBlock && ((packetStart >> (modeBits + 2)) & 1) != 0;
+
+    blockSizeOut = longBlock ? vorbis->blocksize_1 : vorbis->blocksize_0;
+    rightStartOut = (longBlock && !nextLongBlock) ? (blockSizeOut * 3 - vorbis->blocksize_0) / 4 : blockSizeOut / 2;
+    return true;
+}
+
+// Finds where to resume decoding to reach positionInFrames, using a bisection over the pages
+// After a flush, stb_vorbis skips the first page it finds and decodes the packet after it without output,
+// firstFrameOut is the frame of the first sample returned after that
+static bool STBVORBIS_FindSeekPage(STBVORBIS_Music& music, int64_t positionInFrames, STBVORBIS_Page& pageOut, int64_t& firstFrameOut)
+{
+    // The dropped packet ends less than a long block after the page granule position
+    const auto maxGranulePosition = positionInFrames - music.vorbis->blocksize_1;
+    if (maxGranulePosition < 0)
+        return false;
+
+    std::vector<unsigned char> pageBytes;
+    STBVORBIS_Page page;
+
+    // Narrow down to a range holding the last pages before the position
+    auto low = music.audioOffset;
+    auto high = music.fileSize;
+    while (high - low > RAUDIO2_STBVORBIS_BUFFER_SIZE)
+    {
+        auto middle = low + (high - low) / 2;
+
+        auto found = STBVORBIS_FindPage(music, middle, high, page, pageBytes);
+        while (found && page.granulePosition < 0 && page.offset + page.size < high)
+            found = STBVORBIS_ReadPage(music, page.offset + page.size, page, pageBytes);
+
+        if (found && page.granulePosition >= 0 && page.granulePosition <= maxGranulePosition)
+            low = page.offset;
+        else
+            high = middle;
+    }
+
+    // Then walk the pages to the last one we can resume after
+    bool candidateFound = false;
+    bool previousPageFound = false;
+    STBVORBIS_Page previousPage;
+    for (auto found = STBVORBIS_FindPage(music, low, music.fileSize, page, pageBytes); found;
+         found = STBVORBIS_ReadPage(music, page.offset + page.size, page, pageBytes))
+    {
+        // The granule position counts the frames up to the middle of the last block on the page,
+        // the dropped packet returns frames from there to the start of its right window
+        int32_t lastBlockSize{}, lastRightStart{}, blockSize{}, rightStart{};
+        if (previousPageFound && previousPage.granulePosition >= 0 &&
+            STBVORBIS_GetPacketWindow(music.vorbis, previousPage.lastPacketStart, lastBlockSize, lastRightStart) &&
+            STBVORBIS_GetPacketWindow(music.vorbis, page.firstPacketStart, blockSize, rightStart))
+        {
+            pageOut = previousPage;
+            firstFrameOut = previousPage.granulePosition + lastBlockSize / 4 + rightStart - blockSize / 4;
+            candidateFound = true;
+        }
+
+        if (page.granulePosition > maxGranulePosition)
+            break;
+
+        previousPage = page;
+        previousPageFound = true;
+    }
+    return candidateFound;
+}
+
 bool STBVORBIS_Open(RAudio2_WaveInfo* wave_)
 {
     ra::WaveInfo wave = wave_;
@@ -53,38 +384,62 @@ bool STBVORBIS_Open(RAudio2_WaveInfo* wave_)
     if (headerBytes[0] != 'O' && headerBytes[1] != 'g' && headerBytes[2] != 'g' && headerBytes[3] != 'S')
         return false;
 
-    auto vorbisMusic = std::make_unique<STBVORBIS_Music>();
+    auto vorbisMusic = std::make_unique<STBVORBIS_Music>(file);
     if (!vorbisMusic)
         return false;
 
-    file.seek(0);
+    // Decode in place when the file data is already in memory, otherwise stream it through a small buffer
+    vorbisMusic->fileData = (const unsigned char*)file.getBuffer(vorbisMusic->fileSize);
+    if (!vorbisMusic->fileData)
+    {
+        vorbisMusic->fileSize = file.getSize();
+        vorbisMusic->buffer.resize(RAUDIO2_STBVORBIS_BUFFER_SIZE);
+    }
+    STBVORBIS_SetInputOffset(*vorbisMusic, 0);
 
-    auto fileSize = file.getSize();
-    vorbisMusic->fileBytes.resize((std::size_t)fileSize);
+    // The headers can be larger than the buffer, add data until they are complete
+    for (;;)
+    {
+        int inputSize{};
+        auto input = STBVORBIS_GetInput(*vorbisMusic, inputSize);
 
-    file.read(vorbisMusic->fileBytes.data(), fileSize);
+        int bytesUsed{};
+        int error{};
+        vorbisMusic->vorbis = stb_vorbis_open_pushdata(input, inputSize, &bytesUsed, &error, nullptr);
+        if (vorbisMusic->vorbis)
+        {
+            STBVORBIS_ConsumeInput(*vorbisMusic, bytesUsed);
+            break;
+        }
 
-    auto vorbisFile = stb_vorbis_open_memory(vorbisMusic->fileBytes.data(), (int)fileSize, NULL, NULL);
+        if (error != VORBIS_need_more_data || !STBVORBIS_RefillInput(*vorbisMusic))
+            return false;
+    }
 
-    if (vorbisFile)
-    {
-        vorbisMusic->file = vorbisFile;
+    vorbisMusic->audioOffset = vorbisMusic->readOffset;
+    // The copy shares the decoder's pointers. stb_vorbis allocates every buffer once while reading the
+    // headers and only frees them in stb_vorbis_close, so they stay valid for the life of the decoder.
+    // The stream pointers are set again on every pushdata call. Only the live decoder is ever closed
+    vorbisMusic->startState = *vorbisMusic->vorbis;
 
-        wave.setCtxData(vorbisMusic.release());
+    vorbisMusic->frameCount = std::max(STBVORBIS_GetStreamLength(*vorbisMusic), (int64_t)0);
+    STBVORBIS_SetInputOffset(*vorbisMusic, vorbisMusic->audioOffset);
 
-        wave.setSampleFormat(RAUDIO2_SAMPLE_FORMAT_S16);
+    stb_vorbis_info info = stb_vorbis_get_info(vorbisMusic->vorbis);
+    vorbisMusic->channels = info.channels;
+    vorbisMusic->channelOrder = ra::getVorbisChannelOrder(info.channels);
 
-        stb_vorbis_info info = stb_vorbis_get_info(vorbisFile);
-        wave.setSampleRate((int32_t)info.sample_rate);
-        //wave.setChannels((int32_t)info.channels);
-        wave.setChannels(2);
+    // stb_vorbis decodes to float, skip the s16 round trip if the device mixes in float
+    vorbisMusic->floatOutput = wave.getPreferredSampleFormat() == RAUDIO2_SAMPLE_FORMAT_F32;
 
-        // WARNING: It seems this function returns length in frames, not samples, so we multiply by channels
-        wave.setFrameCount((int64_t)stb_vorbis_stream_length_in_samples(vorbisFile));
+    wave.setSampleFormat(vorbisMusic->floatOutput ? RAUDIO2_SAMPLE_FORMAT_F32 : RAUDIO2_SAMPLE_FORMAT_S16);
+    wave.setSampleRate((int32_t)info.sample_rate);
+    wave.setChannels((int32_t)info.channels);
+    wave.setFrameCount(vorbisMusic->frameCount);
 
-        return true;
-    }
-    return false;
+    wave.setCtxData(vorbisMusic.release());
+
+    return true;
 }
 
 bool STBVORBIS_Seek(RAudio2_WaveInfo* wave, int64_t positionInFrames)
@@ -98,12 +453,39 @@ bool STBVORBIS_Seek(RAudio2_WaveInfo* wave, int64_t positionInFrames)
     if (!wave->ctxData)
         return false;
 
-    auto music = (STBVORBIS_Music*)wave->ctxData;
+    auto& music = *(STBVORBIS_Music*)wave->ctxData;
 
-    if (positionInFrames <= 0)
-        return stb_vorbis_seek_start(music->file) == TRUE;
+    positionInFrames = std::clamp(positionInFrames, (int64_t)0, music.frameCount);
 
-    return stb_vorbis_seek_frame(music->file, (unsigned int)positionInFrames) == TRUE;
+    STBVORBIS_Page page;
+    int64_t firstFrame{};
+    if (STBVORBIS_FindSeekPage(music, positionInFrames, page, firstFrame))
+    {
+        stb_vorbis_flush_pushdata(music.vorbis);
+        STBVORBIS_SetInputOffset(music, page.offset);
+        music.position = firstFrame;
+    }
+    else
+    {
+        // Close to the start, decode from the first audio packet (the buffers are shared, see STBVORBIS_Open)
+        *music.vorbis = music.startState;
+        STBVORBIS_SetInputOffset(music, music.audioOffset);
+        music.position = 0;
+    }
+    music.outputFrames = 0;
+
+    // Drop the decoded frames before the position
+    while (music.position < positionInFrames)
+    {
+        if (music.outputFrames == 0 && !STBVORBIS_DecodeFrame(music))
+            return false;
+
+        auto framesToSkip = (int32_t)std::min((int64_t)music.outputFrames, positionInFrames - music.position);
+        music.outputOffset += framesToSkip;
+        music.outputFrames -= framesToSkip;
+        music.position += framesToSkip;
+    }
+    return true;
 }
 
 int64_t STBVORBIS_Read(RAudio2_WaveInfo* wave, void* bufferOut, int64_t framesToRead)
@@ -117,8 +499,37 @@ int64_t STBVORBIS_Read(RAudio2_WaveInfo* wave, void* bufferOut, int64_t framesTo
     if (!wave->ctxData)
         return 0;
 
-    auto music = (STBVORBIS_Music*)wave->ctxData;
-    return stb_vorbis_get_samples_short_interleaved(music->file, music->file->channels, (short*)bufferOut, (int)(framesToRead * music->file->channels));
+    auto& music = *(STBVORBIS_Music*)wave->ctxData;
+
+    int64_t framesRead = 0;
+    while (framesRead < framesToRead)
+    {
+        if (music.outputFrames == 0 && !STBVORBIS_DecodeFrame(music))
+            break;
+
+        auto frameCount = std::min((int64_t)music.outputFrames, framesToRead - framesRead);
+
+        // Interleave straight from the decoder's planar output, picking the planes in device order
+        std::array<const float*, 8> orderedPlanes{};
+        auto planes = (const float* const*)music.output;
+        if (music.channelOrder)
+        {
+            for (int32_t channel = 0; channel < music.channels; channel++)
+                orderedPlanes[channel] = music.output[music.channelOrder[channel]];
+            planes = orderedPlanes.data();
+        }
+
+        if (music.floatOutput)
+            ra::convertPlanarToInterleavedF32(planes, music.channels, music.outputOffset, frameCount, (float*)bufferOut + framesRead * music.channels);
+        else
+            ra::convertPlanarToInterleavedS16(planes, music.channels, music.outputOffset, frameCount, (int16_t*)bufferOut + framesRead * music.channels);
+
+        music.outputOffset += (int32_t)frameCount;
+        music.outputFrames -= (int32_t)frameCount;
+        music.position += frameCount;
+        framesRead += frameCount;
+    }
+    return framesRead;
 }
 
 bool STBVORBIS_Close(RAudio2_WaveInfo* wave)
@@ -129,7 +540,6 @@ bool STBVORBIS_Close(RAudio2_WaveInfo* wave)
         return false;
 
     auto music = (STBVORBIS_Music*)wave->ctxData;
-    stb_vorbis_close(music->file);
     delete music;
     wave->ctxData = nullptr;
     return true;
@@ -148,6 +558,10 @@ bool STBVORBIS_GetValue(RAudio2_WaveInfo* wave, const char* key, int32_t keyLeng
         static const std::array<const char*, 7> extensions{ ".ogg", ".oga", ".ogm", ".ogv", ".ogx", ".spx", nullptr };
         return ra::MakeArrayValue(extensions, *valueOut);
     }
+    case ra::str2int("plugin_signatures"): {
+        static const std::array<RAudio2_Signature, 2> signatures{ { { 28, 7, "\x01vorbis" }, {} } };
+        return ra::MakeArrayValue(signatures, *valueOut);
+    }
     default: {
         break;
     }
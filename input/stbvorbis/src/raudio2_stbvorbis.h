@@ -3,6 +3,10 @@
 #include "raudio2/raudio2_config.h"
 #include "raudio2/raudio2_inputplugin.hpp"
 
+#ifndef RAUDIO2_STBVORBIS_BUFFER_SIZE
+#define RAUDIO2_STBVORBIS_BUFFER_SIZE 65536 // Initial size of the buffer streaming the file to the decoder
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
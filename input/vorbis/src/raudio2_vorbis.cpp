@@ -2,8 +2,10 @@
 #include <algorithm>
 #include <array>
 #include <cctype>
+#include <climits>
 #include <memory>
 #include "raudio2/raudio2_common.hpp"
+#include "raudio2/raudio2_sampleconv.hpp"
 #include "raudio2/raudio2_value.hpp"
 #include "raudio2/raudio2_waveinfo.hpp"
 #include <vorbis/vorbisfile.h>
@@ -62,6 +64,20 @@ static long VORBIS_OnTell(void* datasource)
 
 static ov_callbacks ovCallbacks;
 
+struct VORBIS_Music
+{
+    OggVorbis_File file{};
+    bool opened{ false };
+    bool floatOutput{ false };
+    const int32_t* channelOrder{};
+
+    ~VORBIS_Music()
+    {
+        if (opened)
+            ov_clear(&file);
+    }
+};
+
 bool VORBIS_Init()
 {
     ovCallbacks.read_func = VORBIS_OnRead;
@@ -82,22 +98,44 @@ bool VORBIS_Open(RAudio2_WaveInfo* wave_)
     if (!file)
         return false;
 
-    auto vorbisFile = std::make_unique<OggVorbis_File>();
-    if (!vorbisFile)
+    auto vorbisMusic = std::make_unique<VORBIS_Music>();
+    if (!vorbisMusic)
         return false;
 
-    if (ov_open_callbacks(file.getVirtualIO(), vorbisFile.get(), nullptr, 0, ovCallbacks) == 0)
+    if (ov_open_callbacks(file.getVirtualIO(), &vorbisMusic->file, nullptr, 0, ovCallbacks) == 0)
     {
-        wave.setSampleFormat(RAUDIO2_SAMPLE_FORMAT_S16);
+        vorbisMusic->opened = true;
+
+        // vorbis decodes to float, skip the s16 round trip if the device mixes in float
+        vorbisMusic->floatOutput = wave.getPreferredSampleFormat() == RAUDIO2_SAMPLE_FORMAT_F32;
 
-        auto info = ov_info(vorbisFile.get(), -1);
+        wave.setSampleFormat(vorbisMusic->floatOutput ? RAUDIO2_SAMPLE_FORMAT_F32 : RAUDIO2_SAMPLE_FORMAT_S16);
+
+        auto info = ov_info(&vorbisMusic->file, -1);
 
         wave.setSampleRate((int32_t)info->rate);
         wave.setChannels((int32_t)info->channels);
 
-        wave.setFrameCount(ov_pcm_total(vorbisFile.get(), -1));
+        vorbisMusic->channelOrder = ra::getVorbisChannelOrder(info->channels);
+
+        // Chained streams play up to the first link changing the channel count or the rate
+        int64_t frameCount = 0;
+        for (int link = 0; link < ov_streams(&vorbisMusic->file); link++)
+        {
+            auto linkInfo = ov_info(&vorbisMusic->file, link);
+            if (linkInfo->channels != info->channels || linkInfo->rate != info->rate)
+                break;
+            auto linkFrames = ov_pcm_total(&vorbisMusic->file, link);
+            if (linkFrames < 0)
+            {
+                frameCount = linkFrames;
+                break;
+            }
+            frameCount += linkFrames;
+        }
+        wave.setFrameCount(frameCount);
 
-        wave.setCtxData(vorbisFile.release());
+        wave.setCtxData(vorbisMusic.release());
 
         return true;
     }
@@ -115,12 +153,12 @@ bool VORBIS_Seek(RAudio2_WaveInfo* wave, int64_t positionInFrames)
     if (!wave->ctxData)
         return false;
 
-    auto vorbisFile = (OggVorbis_File*)wave->ctxData;
+    auto music = (VORBIS_Music*)wave->ctxData;
 
     if (positionInFrames <= 0)
         positionInFrames = 0;
 
-    return ov_pcm_seek(vorbisFile, positionInFrames) == 0;
+    return ov_pcm_seek(&music->file, positionInFrames) == 0;
 }
 
 int64_t VORBIS_Read(RAudio2_WaveInfo* wave, void* bufferOut, int64_t framesToRead)
@@ -134,33 +172,47 @@ int64_t VORBIS_Read(RAudio2_WaveInfo* wave, void* bufferOut, int64_t framesToRea
     if (!wave->ctxData)
         return 0;
 
-    auto vorbisFile = (OggVorbis_File*)wave->ctxData;
+    auto music = (VORBIS_Music*)wave->ctxData;
 
-    auto numBytes = (int)(framesToRead * wave->channels * 2);
-    int currentSection{};
-    int totalBytesRead{};
+    auto bytesPerFrame = (int64_t)wave->channels * (music->floatOutput ? (int64_t)sizeof(float) : (int64_t)sizeof(int16_t));
+    int64_t framesRead = 0;
 
-    while (numBytes >= wave->channels * 2)
+    while (framesRead < framesToRead)
     {
-        auto bytesRead = ov_read(vorbisFile, (char*)bufferOut, numBytes, 0, 2, 1, &currentSection);
+        float** pcm{};
+        int currentSection{};
+        auto samplesRead = ov_read_float(&music->file, &pcm, (int)std::min(framesToRead - framesRead, (int64_t)INT_MAX), &currentSection);
 
-        if (bytesRead == OV_HOLE)
-        {
+        if (samplesRead == OV_HOLE)
             continue;
-        }
-        else if (bytesRead <= 0)
-        {
+        else if (samplesRead <= 0)
             break;
-        }
-        else
+
+        // Chained streams that change the channel count or the rate end here, the planes don't match the output
+        auto linkInfo = ov_info(&music->file, currentSection);
+        if (linkInfo->channels != wave->channels || linkInfo->rate != wave->sampleRate)
+            break;
+
+        // Interleave straight from the decoder's planar output, picking the planes in device order
+        std::array<const float*, 8> orderedPlanes{};
+        auto planes = (const float* const*)pcm;
+        if (music->channelOrder)
         {
-            totalBytesRead += bytesRead;
-            bufferOut = (void*)((unsigned char*)bufferOut + bytesRead);
-            numBytes -= bytesRead;
+            for (int32_t channel = 0; channel < wave->channels; channel++)
+                orderedPlanes[channel] = pcm[music->channelOrder[channel]];
+            planes = orderedPlanes.data();
         }
+
+        auto bufferPtr = (unsigned char*)bufferOut + framesRead * bytesPerFrame;
+        if (music->floatOutput)
+            ra::convertPlanarToInterleavedF32(planes, wave->channels, 0, samplesRead, (float*)bufferPtr);
+        else
+            ra::convertPlanarToInterleavedS16(planes, wave->channels, 0, samplesRead, (int16_t*)bufferPtr);
+
+        framesRead += samplesRead;
     }
 
-    return (uint64_t)(totalBytesRead / (wave->channels * 2));
+    return framesRead;
 }
 
 bool VORBIS_Close(RAudio2_WaveInfo* wave)
@@ -170,9 +222,9 @@ bool VORBIS_Close(RAudio2_WaveInfo* wave)
     if (!wave->ctxData)
         return false;
 
-    auto vorbisFile = (OggVorbis_File*)wave->ctxData;
+    auto music = (VORBIS_Music*)wave->ctxData;
 
-    ov_clear(vorbisFile);
+    delete music;
     wave->ctxData = nullptr;
     return true;
 }
@@ -220,11 +272,17 @@ bool VORBIS_GetValue(RAudio2_WaveInfo* wave, const char* key, int32_t keyLength,
         static const std::array<const char*, 7> extensions{ ".ogg", ".oga", ".ogm", ".ogv", ".ogx", ".spx", nullptr };
         return ra::MakeArrayValue(extensions, *valueOut);
     }
+    case ra::str2int("plugin_signatures"): {
+        static const std::array<RAudio2_Signature, 2> signatures{ { { 28, 7, "\x01vorbis" }, {} } };
+        return ra::MakeArrayValue(signatures, *valueOut);
+    }
     default: {
-        auto vorbisFile = (OggVorbis_File*)wave->ctxData;
-        if (!vorbisFile)
+        auto music = (VORBIS_Music*)wave->ctxData;
+        if (!music)
             break;
 
+        auto vorbisFile = &music->file;
+
         auto tags = ov_comment(vorbisFile, -1);
 
         constexpr auto vobTagArtist = "artist="sv;
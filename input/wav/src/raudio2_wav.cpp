@@ -10,7 +10,9 @@
 #define DRWAV_FREE RAUDIO2_FREE
 #endif
 
+#include <algorithm>
 #include <array>
+#include <cstring>
 
 #define DR_WAV_IMPLEMENTATION
 #define DR_WAV_NO_STDIO
@@ -32,6 +34,7 @@ bool WAV_MakeInputPlugin(RAudio2_InputPlugin* plugin)
     plugin->open = WAV_Open;
     plugin->seek = WAV_Seek;
     plugin->read = WAV_Read;
+    plugin->readBorrow = WAV_ReadBorrow;
     plugin->close = WAV_Close;
     plugin->getValue = WAV_GetValue;
 
@@ -58,6 +61,28 @@ static drwav_bool32 WAV_OnSeek(void* pUserData, int offset, drwav_seek_origin or
     return file->seek(file->handle, offset, (origin == drwav_seek_origin_current) ? RAUDIO2_SEEK_CUR : RAUDIO2_SEEK_SET) >= 0;
 }
 
+struct WAV_Music
+{
+    drwav wav{};
+    const unsigned char* pcmData{ nullptr }; // Data chunk when the file is in memory in the output format, lent as is
+    int64_t pcmFrameCount{};
+    int64_t frameSize{};
+    int64_t position{};
+};
+
+// s16 and f32 PCM in a little endian container is already in the output format
+static bool WAV_IsOutputFormat(const drwav& wav, RAudio2_SampleFormat sampleFormat)
+{
+    if (wav.container != drwav_container_riff && wav.container != drwav_container_w64 && wav.container != drwav_container_rf64)
+        return false;
+    if (wav.fmt.blockAlign != wav.channels * wav.bitsPerSample / 8)
+        return false;
+
+    if (sampleFormat == RAUDIO2_SAMPLE_FORMAT_S16)
+        return wav.translatedFormatTag == DR_WAVE_FORMAT_PCM && wav.bitsPerSample == 16;
+    return wav.translatedFormatTag == DR_WAVE_FORMAT_IEEE_FLOAT && wav.bitsPerSample == 32;
+}
+
 bool WAV_Open(RAudio2_WaveInfo* wave)
 {
     if (!wave)
@@ -67,32 +92,45 @@ bool WAV_Open(RAudio2_WaveInfo* wave)
     if (!wave->file->handle)
         return false;
 
-    drwav* ctxWav = (drwav*)calloc(1, sizeof(drwav));
-    bool success = drwav_init_with_metadata(ctxWav, WAV_OnRead, WAV_OnSeek, wave->file, 0, nullptr) == DRWAV_TRUE;
+    auto music = new WAV_Music();
 
-    wave->ctxData = ctxWav;
+    // drwav_init cleans up after itself on failure, only the context is left to free
+    if (drwav_init_with_metadata(&music->wav, WAV_OnRead, WAV_OnSeek, wave->file, 0, nullptr) != DRWAV_TRUE)
+    {
+        delete music;
+        return false;
+    }
 
-    if (success && ctxWav)
+    wave->ctxData = music;
+
+    auto& wav = music->wav;
+    switch (wav.bitsPerSample)
     {
-        switch (ctxWav->bitsPerSample)
-        {
-        case 8:
-        case 16: {
-            wave->sampleFormat = RAUDIO2_SAMPLE_FORMAT_S16;
-            break;
-        }
-        default: {
-            wave->sampleFormat = RAUDIO2_SAMPLE_FORMAT_F32;
-            break;
-        }
-        }
+    case 8:
+    case 16: {
+        wave->sampleFormat = RAUDIO2_SAMPLE_FORMAT_S16;
+        break;
+    }
+    default: {
+        wave->sampleFormat = RAUDIO2_SAMPLE_FORMAT_F32;
+        break;
+    }
+    }
 
-        wave->sampleRate = (int32_t)ctxWav->sampleRate;
-        wave->channels = (int32_t)ctxWav->channels;
-        wave->frameCount = (int64_t)ctxWav->totalPCMFrameCount;
-        return true;
+    wave->sampleRate = (int32_t)wav.sampleRate;
+    wave->channels = (int32_t)wav.channels;
+    wave->frameCount = (int64_t)wav.totalPCMFrameCount;
+
+    // Files in memory that are already in the output format are lent without decoding
+    int64_t fileSize{};
+    auto fileData = (const unsigned char*)(wave->file->getBuffer ? wave->file->getBuffer(wave->file->handle, &fileSize) : nullptr);
+    if (fileData && WAV_IsOutputFormat(wav, (RAudio2_SampleFormat)wave->sampleFormat) && (int64_t)wav.dataChunkDataPos <= fileSize)
+    {
+        music->frameSize = (int64_t)wav.fmt.blockAlign;
+        music->pcmData = fileData + wav.dataChunkDataPos;
+        music->pcmFrameCount = std::min((int64_t)wav.totalPCMFrameCount, (fileSize - (int64_t)wav.dataChunkDataPos) / music->frameSize);
     }
-    return false;
+    return true;
 }
 
 bool WAV_Seek(RAudio2_WaveInfo* wave, int64_t positionInFrames)
@@ -106,10 +144,45 @@ bool WAV_Seek(RAudio2_WaveInfo* wave, int64_t positionInFrames)
     if (!wave->ctxData)
         return false;
 
+    auto music = (WAV_Music*)wave->ctxData;
+
+    if (music->pcmData)
+    {
+        music->position = std::clamp(positionInFrames, (int64_t)0, music->pcmFrameCount);
+        return true;
+    }
+
     if (positionInFrames <= 0)
-        return drwav_seek_to_first_pcm_frame((drwav*)wave->ctxData) == DRWAV_TRUE;
+        return drwav_seek_to_first_pcm_frame(&music->wav) == DRWAV_TRUE;
+
+    return drwav_seek_to_pcm_frame(&music->wav, (drwav_uint64)positionInFrames) == DRWAV_TRUE;
+}
+
+int64_t WAV_ReadBorrow(RAudio2_WaveInfo* wave, const void** framesOut, int64_t maxFrames)
+{
+    if (!wave)
+        return 0;
+    if (!wave->file)
+        return 0;
+    if (!wave->file->handle)
+        return 0;
+    if (!wave->ctxData)
+        return 0;
+
+    auto music = (WAV_Music*)wave->ctxData;
+
+    // Frames that need decoding go through WAV_Read
+    if (!music->pcmData)
+        return -1;
+
+    auto framesBorrowed = std::min(maxFrames, music->pcmFrameCount - music->position);
+    if (framesBorrowed <= 0)
+        return 0;
+
+    *framesOut = music->pcmData + music->position * music->frameSize;
+    music->position += framesBorrowed;
 
-    return drwav_seek_to_pcm_frame((drwav*)wave->ctxData, (drwav_uint64)positionInFrames) == DRWAV_TRUE;
+    return framesBorrowed;
 }
 
 int64_t WAV_Read(RAudio2_WaveInfo* wave, void* bufferOut, int64_t framesToRead)
@@ -123,10 +196,23 @@ int64_t WAV_Read(RAudio2_WaveInfo* wave, void* bufferOut, int64_t framesToRead)
     if (!wave->ctxData)
         return 0;
 
+    auto music = (WAV_Music*)wave->ctxData;
+
+    if (music->pcmData)
+    {
+        const void* frames{};
+        auto framesBorrowed = WAV_ReadBorrow(wave, &frames, framesToRead);
+        if (framesBorrowed <= 0)
+            return 0;
+
+        std::memcpy(bufferOut, frames, (size_t)(framesBorrowed * music->frameSize));
+        return framesBorrowed;
+    }
+
     if (wave->sampleFormat == RAUDIO2_SAMPLE_FORMAT_S16)
-        return drwav_read_pcm_frames_s16((drwav*)wave->ctxData, (drwav_uint64)framesToRead, (drwav_int16*)bufferOut);
+        return drwav_read_pcm_frames_s16(&music->wav, (drwav_uint64)framesToRead, (drwav_int16*)bufferOut);
     else
-        return drwav_read_pcm_frames_f32((drwav*)wave->ctxData, (drwav_uint64)framesToRead, (float*)bufferOut);
+        return drwav_read_pcm_frames_f32(&music->wav, (drwav_uint64)framesToRead, (float*)bufferOut);
 
     return 0;
 }
@@ -138,8 +224,10 @@ bool WAV_Close(RAudio2_WaveInfo* wave)
     if (!wave->ctxData)
         return false;
 
-    drwav_uninit((drwav*)wave->ctxData);
-    free(wave->ctxData);
+    auto music = (WAV_Music*)wave->ctxData;
+    drwav_uninit(&music->wav);
+    delete music;
+    wave->ctxData = nullptr;
     return true;
 }
 
@@ -206,11 +294,20 @@ bool WAV_GetValue(RAudio2_WaveInfo* wave, const char* key, int32_t keyLength, RA
         static const std::array<const char*, 5> extensions{ ".wav", ".wave", ".aif", ".aiff", nullptr };
         return ra::MakeArrayValue(extensions, *valueOut);
     }
+    case ra::str2int("plugin_signatures"): {
+        static const std::array<RAudio2_Signature, 6> signatures{ {
+            { 0, 4, "RIFF" }, { 0, 4, "RIFX" }, { 0, 4, "RF64" },
+            { 0, 4, "FORM" }, { 0, 8, "riff\x2E\x91\xCF\x11" }, {}
+        } };
+        return ra::MakeArrayValue(signatures, *valueOut);
+    }
     default: {
-        auto ctxWav = (drwav*)wave->ctxData;
-        if (!ctxWav)
+        auto music = (WAV_Music*)wave->ctxData;
+        if (!music)
             break;
 
+        auto ctxWav = &music->wav;
+
         switch (keyHash)
         {
         case ra::str2int("album"): {
@@ -17,6 +17,8 @@ bool WAV_Open(RAudio2_WaveInfo* wave);
 
 int64_t WAV_Read(RAudio2_WaveInfo* wave, void* bufferOut, int64_t framesToRead);
 
+int64_t WAV_ReadBorrow(RAudio2_WaveInfo* wave, const void** framesOut, int64_t maxFrames);
+
 bool WAV_Seek(RAudio2_WaveInfo* wave, int64_t positionInFrames);
 
 bool WAV_Close(RAudio2_WaveInfo* wave);
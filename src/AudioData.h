@@ -9,8 +9,6 @@ struct AudioDataSystem {
     ma_device device;          // miniaudio device
     ma_mutex lock;             // miniaudio mutex lock
     std::atomic<bool> isReady; // Check if audio device is ready
-    int32_t pcmBufferSize;     // Pre-allocated buffer size
-    void* pcmBuffer;           // Pre-allocated buffer to read audio data from file/memory
 };
 
 struct AudioDataBuffer {
@@ -1,4 +1,5 @@
 #include "AudioDevice.h"
+#include "BlockCache.h"
 #include <cstring>
 #include "raudio2/raudio2_common.hpp"
 #include "SampleFormat.h"
@@ -81,7 +82,7 @@ void AudioDevice::UpdateThreadFunction()
         ma_mutex_lock(&audioData.system.lock);
         for (const auto& music : musics)
         {
-            music.second->Update(audioData);
+            music.second->Update();
         }
         ma_mutex_unlock(&audioData.system.lock);
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
@@ -251,13 +252,11 @@ void AudioDevice::Uninit()
     ma_device_uninit(&audioData.system.device);
     ma_context_uninit(&audioData.system.context);
 
-    RAUDIO2_FREE(audioData.system.pcmBuffer);
-    audioData.system.pcmBuffer = nullptr;
-    audioData.system.pcmBufferSize = 0;
-
     musics.clear();
+    archives.clear();
     streams.clear();
     inputPlugins.clear();
+    inputPluginExtensions.clear();
     archivePlugins.clear();
 
     RAUDIO2_TRACELOG(LOG_INFO, "AUDIO: Device closed successfully");
@@ -376,9 +375,40 @@ bool AudioDevice::RegisterInputPlugin(const RAudio2_InputPlugin& plugin, bool ap
 
     inputPluginNames.insert(inputPluginNames.end() - 1, name.data());
 
+    UpdateInputPluginExtensions();
+
     return true;
 }
 
+void AudioDevice::UpdateInputPluginExtensions()
+{
+    inputPluginExtensions.clear();
+
+    for (const auto& plugin : inputPlugins)
+    {
+        ra::InputPlugin raPlugin(plugin.get());
+
+        auto extPtr = raPlugin.getExtensions();
+        if (!extPtr)
+            continue;
+
+        for (; *extPtr; extPtr++)
+            inputPluginExtensions[*extPtr].push_back(plugin.get());
+    }
+}
+
+const std::vector<const RAudio2_InputPlugin*>* AudioDevice::InputPluginsByExtension(const char* fileName) const
+{
+    auto fileExt = strrchr(fileName, '.');
+    if (!fileExt)
+        return nullptr;
+
+    auto it = inputPluginExtensions.find(fileExt);
+    if (it != inputPluginExtensions.end())
+        return &it->second;
+    return nullptr;
+}
+
 int32_t AudioDevice::AddAudioStream(const std::shared_ptr<AudioStream>& stream)
 {
     auto id = stream->GetID();
@@ -393,6 +423,13 @@ int32_t AudioDevice::AddMusic(std::unique_ptr<Music>&& music)
     return id;
 }
 
+int32_t AudioDevice::AddArchive(std::shared_ptr<MusicArchive>&& archive)
+{
+    auto id = archive->GetID();
+    archives.emplace(id, std::move(archive));
+    return id;
+}
+
 AudioStream* AudioDevice::GetAudioStream(int32_t streamId) const
 {
     auto it = streams.find(streamId);
@@ -409,6 +446,14 @@ Music* AudioDevice::GetMusic(int32_t musicId) const
     return nullptr;
 }
 
+std::shared_ptr<MusicArchive> AudioDevice::GetArchive(int32_t archiveId) const
+{
+    auto it = archives.find(archiveId);
+    if (it != archives.end())
+        return it->second;
+    return nullptr;
+}
+
 bool AudioDevice::DeleteAudioStream(int32_t streamId)
 {
     return streams.erase(streamId) > 0;
@@ -419,6 +464,11 @@ bool AudioDevice::DeleteMusic(int32_t musicId)
     return musics.erase(musicId) > 0;
 }
 
+bool AudioDevice::DeleteArchive(int32_t archiveId)
+{
+    return archives.erase(archiveId) > 0;
+}
+
 RAudio2_SampleFormat AudioDevice::GetFormat()
 {
     return (RAudio2_SampleFormat)audioData.system.device.playback.format;
@@ -889,6 +939,27 @@ bool AudioDevice::GetValue(const char* key_, int32_t keyLength, RAudio2_Value* v
         return ra::MakeArrayValue(archivePluginNames, *valueOut);
         return true;
     }
+    case ra::str2int("block_cache"): {
+
+        auto stats = BlockCache::Get().getStats();
+
+        switch (ra::str2int(query.substr(0, 32)))
+        {
+        case ra::str2int("hits"):
+            return ra::MakeValue(stats.hits, *valueOut);
+        case ra::str2int("misses"):
+            return ra::MakeValue(stats.misses, *valueOut);
+        case ra::str2int("size"):
+            return ra::MakeValue(stats.size, *valueOut);
+        case ra::str2int("budget"):
+            return ra::MakeValue(stats.budget, *valueOut);
+        case ra::str2int("block_count"):
+            return ra::MakeValue(stats.blockCount, *valueOut);
+        default:
+            break;
+        }
+        break;
+    }
     case ra::str2int("input"): {
 
         auto [pluginName, pluginQuery] = ra::splitKey(query);
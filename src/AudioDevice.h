@@ -5,8 +5,10 @@
 #include "FileIO.h"
 #include <memory>
 #include "Music.h"
+#include "MusicArchive.h"
 #include "raudio2/raudio2.hpp"
 #include "raudio2/raudio2_archiveplugin.hpp"
+#include <string>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -22,12 +24,17 @@ private:
     std::vector<const char*> archivePluginNames{ nullptr };
     std::vector<const char*> inputPluginNames{ nullptr };
 
+    // Input plugins by file extension, in registration order
+    std::unordered_map<std::string, std::vector<const RAudio2_InputPlugin*>> inputPluginExtensions;
+
     std::unordered_map<int32_t, std::shared_ptr<AudioStream>> streams;
     std::unordered_map<int32_t, std::unique_ptr<Music>> musics;
+    std::unordered_map<int32_t, std::shared_ptr<MusicArchive>> archives;
 
     std::jthread updateThread;
 
     void UpdateThreadFunction();
+    void UpdateInputPluginExtensions();
 
 public:
     AudioDevice() = default;
@@ -51,6 +58,8 @@ public:
     auto& ArchivePlugins() const { return archivePlugins; }
     auto& InputPlugins() const { return inputPlugins; }
 
+    const std::vector<const RAudio2_InputPlugin*>* InputPluginsByExtension(const char* fileName) const;
+
     bool RegisterPlugin(const char* filePath, RAudio2_PluginType pluginType, bool append);
 
     bool RegisterArchivePlugin(bool (*getArchivePlugin)(RAudio2_ArchivePlugin*), bool append);
@@ -61,12 +70,15 @@ public:
 
     int32_t AddAudioStream(const std::shared_ptr<AudioStream>& stream);
     int32_t AddMusic(std::unique_ptr<Music>&& music);
+    int32_t AddArchive(std::shared_ptr<MusicArchive>&& archive);
 
     AudioStream* GetAudioStream(int32_t streamId) const;
     Music* GetMusic(int32_t musicId) const;
+    std::shared_ptr<MusicArchive> GetArchive(int32_t archiveId) const;
 
     bool DeleteAudioStream(int32_t streamId);
     bool DeleteMusic(int32_t musicId);
+    bool DeleteArchive(int32_t archiveId);
 
     RAudio2_SampleFormat GetFormat();
     int32_t GetSampleRate();
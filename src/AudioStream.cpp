@@ -1,4 +1,5 @@
 #include "AudioStream.h"
+#include <algorithm>
 #include "AudioDevice.h"
 #include <cstring>
 #include <miniaudio.h>
@@ -83,54 +84,70 @@ bool AudioStream::IsReady()
 
 void AudioStream::Update(const void* dataIn, int64_t frameCount)
 {
-    if (buffer != nullptr)
+    if (buffer == nullptr)
+        return;
+
+    // Does this API expect a whole buffer to be updated in one go?
+    // Assuming so, but if not will need to change this logic.
+    if ((int64_t)(buffer->sizeInFrames / 2) < frameCount)
+    {
+        RAUDIO2_TRACELOG(RAUDIO2_LOG_WARNING, "STREAM: Attempting to write too many frames to buffer");
+        return;
+    }
+
+    int32_t subBufferIndex = 0;
+    auto subBuffer = BeginUpdate(subBufferIndex);
+
+    if (subBuffer != nullptr)
     {
-        if (buffer->isSubBufferProcessed[0] || buffer->isSubBufferProcessed[1])
-        {
-            ma_uint32 subBufferToUpdate = 0;
-
-            if (buffer->isSubBufferProcessed[0] && buffer->isSubBufferProcessed[1])
-            {
-                // Both buffers are available for updating.
-                // Update the first one and make sure the cursor is moved back to the front.
-                subBufferToUpdate = 0;
-                buffer->frameCursorPos = 0;
-            }
-            else
-            {
-                // Just update whichever sub-buffer is processed.
-                subBufferToUpdate = (buffer->isSubBufferProcessed[0]) ? 0 : 1;
-            }
-
-            ma_uint32 subBufferSizeInFrames = buffer->sizeInFrames / 2;
-            unsigned char* subBuffer = buffer->data + ((subBufferSizeInFrames * channels * (sampleSize / 8)) * subBufferToUpdate);
-
-            // Total frames processed in buffer is always the complete size, filled with 0 if required
-            buffer->framesProcessed += subBufferSizeInFrames;
-
-            // Does this API expect a whole buffer to be updated in one go?
-            // Assuming so, but if not will need to change this logic.
-            if (subBufferSizeInFrames >= (ma_uint32)frameCount)
-            {
-                ma_uint32 framesToWrite = (ma_uint32)frameCount;
-
-                ma_uint32 bytesToWrite = framesToWrite * channels * (sampleSize / 8);
-                memcpy(subBuffer, dataIn, bytesToWrite);
-
-                // Any leftover frames should be filled with zeros.
-                ma_uint32 leftoverFrameCount = subBufferSizeInFrames - framesToWrite;
-
-                if (leftoverFrameCount > 0)
-                    memset(subBuffer + bytesToWrite, 0, leftoverFrameCount * channels * (sampleSize / 8));
-
-                buffer->isSubBufferProcessed[subBufferToUpdate] = false;
-            }
-            else
-                RAUDIO2_TRACELOG(RAUDIO2_LOG_WARNING, "STREAM: Attempting to write too many frames to buffer");
-        }
-        else
-            RAUDIO2_TRACELOG(RAUDIO2_LOG_WARNING, "STREAM: Buffer not available for updating");
+        memcpy(subBuffer, dataIn, (size_t)frameCount * channels * (sampleSize / 8));
+        EndUpdate(subBufferIndex, frameCount);
     }
+    else
+        RAUDIO2_TRACELOG(RAUDIO2_LOG_WARNING, "STREAM: Buffer not available for updating");
+}
+
+unsigned char* AudioStream::BeginUpdate(int32_t& subBufferIndex)
+{
+    if (buffer == nullptr)
+        return nullptr;
+
+    if (!buffer->isSubBufferProcessed[0] && !buffer->isSubBufferProcessed[1])
+        return nullptr;
+
+    if (buffer->isSubBufferProcessed[0] && buffer->isSubBufferProcessed[1])
+    {
+        // Both buffers are available for updating.
+        // Update the first one and make sure the cursor is moved back to the front.
+        subBufferIndex = 0;
+        buffer->frameCursorPos = 0;
+    }
+    else
+    {
+        // Just update whichever sub-buffer is processed.
+        subBufferIndex = (buffer->isSubBufferProcessed[0]) ? 0 : 1;
+    }
+
+    ma_uint32 subBufferSizeInFrames = buffer->sizeInFrames / 2;
+    return buffer->data + ((subBufferSizeInFrames * channels * (sampleSize / 8)) * subBufferIndex);
+}
+
+void AudioStream::EndUpdate(int32_t subBufferIndex, int64_t frameCount)
+{
+    ma_uint32 subBufferSizeInFrames = buffer->sizeInFrames / 2;
+    unsigned char* subBuffer = buffer->data + ((subBufferSizeInFrames * channels * (sampleSize / 8)) * subBufferIndex);
+
+    // Total frames processed in buffer is always the complete size, filled with 0 if required
+    buffer->framesProcessed += subBufferSizeInFrames;
+
+    // Any leftover frames should be filled with zeros.
+    auto framesWritten = (ma_uint32)std::clamp(frameCount, (int64_t)0, (int64_t)subBufferSizeInFrames);
+    ma_uint32 leftoverFrameCount = subBufferSizeInFrames - framesWritten;
+
+    if (leftoverFrameCount > 0)
+        memset(subBuffer + framesWritten * channels * (sampleSize / 8), 0, leftoverFrameCount * channels * (sampleSize / 8));
+
+    buffer->isSubBufferProcessed[subBufferIndex] = false;
 }
 
 bool AudioStream::IsProcessed()
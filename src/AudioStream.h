@@ -37,6 +37,12 @@ public:
     void Unload(AudioDevice& audioDevice);
     bool IsReady();
     void Update(const void* dataIn, int64_t samplesCount);
+
+    // Get the next sub-buffer to refill (nullptr if none is available), to write frames in place
+    unsigned char* BeginUpdate(int32_t& subBufferIndex);
+
+    // Mark a sub-buffer as refilled, frames after frameCount are filled with zeros
+    void EndUpdate(int32_t subBufferIndex, int64_t frameCount);
     bool IsProcessed();
     void Play();
     void Pause();
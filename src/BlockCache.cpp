@@ -0,0 +1,106 @@
+#include "BlockCache.h"
+
+size_t BlockCache::KeyHash::operator()(const Key& key) const noexcept
+{
+    // FNV-1a over the fields
+    uint64_t hash = 14695981039346656037ull;
+    for (auto value : { key.file.device, key.file.index, (uint64_t)key.file.modifiedTime, (uint64_t)key.file.changedTime, (uint64_t)key.file.size, (uint64_t)key.blockIndex })
+    {
+        hash ^= value;
+        hash *= 1099511628211ull;
+    }
+    return (size_t)hash;
+}
+
+BlockCache::BlockCache() noexcept
+{
+    stats.budget = RAUDIO2_BLOCK_CACHE_BUDGET;
+}
+
+BlockCache& BlockCache::Get()
+{
+    static BlockCache cache;
+    return cache;
+}
+
+std::shared_ptr<const BlockCache::Block> BlockCache::get(const FileIdentity& identity, FileIO& file, int64_t blockIndex)
+{
+    Key key{ identity, blockIndex };
+    std::promise<std::shared_ptr<const Block>> promise;
+    std::shared_future<std::shared_ptr<const Block>> pendingBlock;
+    {
+        std::lock_guard lock(mutex);
+
+        auto it = entries.find(key);
+        if (it != entries.end())
+        {
+            stats.hits++;
+            lru.splice(lru.begin(), lru, it->second.lruPosition);
+            return it->second.block;
+        }
+
+        auto pendingIt = pending.find(key);
+        if (pendingIt != pending.end())
+        {
+            stats.hits++;
+            pendingBlock = pendingIt->second;
+        }
+        else
+        {
+            stats.misses++;
+            pending.emplace(key, promise.get_future().share());
+        }
+    }
+
+    if (pendingBlock.valid())
+        return pendingBlock.get();
+
+    // Read outside the lock, readers of other blocks don't wait for it
+    auto block = std::make_shared<Block>(RAUDIO2_BLOCK_CACHE_BLOCK_SIZE);
+    auto bytesRead = file.readAt(block->data(), (int64_t)block->size(), blockIndex * RAUDIO2_BLOCK_CACHE_BLOCK_SIZE);
+    if (bytesRead > 0)
+        block->resize((size_t)bytesRead);
+    else
+        block.reset();
+
+    {
+        std::lock_guard lock(mutex);
+
+        pending.erase(key);
+        if (block)
+            insert(key, block);
+    }
+
+    // Failed reads aren't cached, the waiting readers fail as well
+    promise.set_value(block);
+    return block;
+}
+
+void BlockCache::insert(const Key& key, std::shared_ptr<const Block> block)
+{
+    lru.push_front(key);
+    stats.size += (int64_t)block->size();
+    entries.emplace(key, Entry{ std::move(block), lru.begin() });
+    trim();
+}
+
+BlockCache::Stats BlockCache::getStats() const
+{
+    std::lock_guard lock(mutex);
+
+    auto statsOut = stats;
+    statsOut.blockCount = (int64_t)entries.size();
+    return statsOut;
+}
+
+void BlockCache::trim()
+{
+    // Blocks still used by readers stay alive through their shared_ptr
+    while (stats.size > stats.budget && !lru.empty())
+    {
+        auto it = entries.find(lru.back());
+        stats.size -= (int64_t)it->second.block->size();
+        entries.erase(it);
+        lru.pop_back();
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include "FileIO.h"
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#ifndef RAUDIO2_BLOCK_CACHE_BLOCK_SIZE
+#define RAUDIO2_BLOCK_CACHE_BLOCK_SIZE 65536 // Size of a cached file block
+#endif
+#ifndef RAUDIO2_BLOCK_CACHE_BUDGET
+#define RAUDIO2_BLOCK_CACHE_BUDGET 33554432 // Maximum size of all cached blocks (32 MiB)
+#endif
+
+// Process wide cache of file blocks, shared by every stream reading the same file
+// NOTE: Least recently used blocks are dropped when the budget is exceeded
+class BlockCache
+{
+public:
+    using Block = std::vector<unsigned char>;
+
+    struct Stats
+    {
+        int64_t hits{};
+        int64_t misses{};
+        int64_t size{};   // Bytes of cached data
+        int64_t budget{}; // Maximum bytes of cached data
+        int64_t blockCount{};
+    };
+
+private:
+    struct Key
+    {
+        FileIdentity file;
+        int64_t blockIndex{};
+
+        bool operator==(const Key&) const = default;
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const noexcept;
+    };
+
+    struct Entry
+    {
+        std::shared_ptr<const Block> block;
+        std::list<Key>::iterator lruPosition;
+    };
+
+    std::unordered_map<Key, Entry, KeyHash> entries;
+    std::unordered_map<Key, std::shared_future<std::shared_ptr<const Block>>, KeyHash> pending; // Blocks being read by a reader
+    std::list<Key> lru; // Most recently used first
+    Stats stats;
+    mutable std::mutex mutex;
+
+    BlockCache() noexcept;
+
+    // Must be called with mutex locked
+    void insert(const Key& key, std::shared_ptr<const Block> block);
+
+    void trim();
+
+public:
+    BlockCache(BlockCache const&) = delete;
+    BlockCache& operator=(BlockCache const&) = delete;
+
+    static BlockCache& Get();
+
+    // Returns the cached block, reading it from the file on a miss
+    // NOTE: Readers missing a block another reader is reading wait for it instead of reading it again
+    std::shared_ptr<const Block> get(const FileIdentity& identity, FileIO& file, int64_t blockIndex);
+
+    Stats getStats() const;
+};
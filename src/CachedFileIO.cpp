@@ -0,0 +1,112 @@
+#include "CachedFileIO.h"
+#include <algorithm>
+#include <cstring>
+
+CachedFileIO::CachedFileIO(std::unique_ptr<FileIO>&& file_) noexcept : file(std::move(file_))
+{
+    if (file)
+        cacheable = file->getIdentity(identity);
+}
+
+std::shared_ptr<const BlockCache::Block> CachedFileIO::getBlock(int64_t blockIndex)
+{
+    if (blockIndex == currentBlockIndex)
+        return currentBlock;
+
+    auto block = BlockCache::Get().get(identity, *file, blockIndex);
+    if (!block)
+        return {};
+
+    currentBlock = block;
+    currentBlockIndex = blockIndex;
+    return block;
+}
+
+int64_t CachedFileIO::read(void* ptr, int64_t count) noexcept
+{
+    auto bytesRead = readAt(ptr, count, currentOffset);
+    currentOffset += bytesRead;
+    return bytesRead;
+}
+
+int64_t CachedFileIO::readAt(void* ptr, int64_t count, int64_t offset) noexcept
+{
+    if (!file || count <= 0 || offset < 0)
+        return 0;
+
+    if (!cacheable)
+        return file->readAt(ptr, count, offset);
+
+    auto out = (unsigned char*)ptr;
+    int64_t totalRead = 0;
+
+    while (count > 0)
+    {
+        auto blockIndex = offset / RAUDIO2_BLOCK_CACHE_BLOCK_SIZE;
+        auto block = getBlock(blockIndex);
+        if (!block)
+            break;
+
+        auto blockOffset = offset - blockIndex * RAUDIO2_BLOCK_CACHE_BLOCK_SIZE;
+        if (blockOffset >= (int64_t)block->size())
+            break;
+
+        auto bytesToCopy = std::min(count, (int64_t)block->size() - blockOffset);
+        std::memcpy(out, block->data() + blockOffset, (size_t)bytesToCopy);
+        out += bytesToCopy;
+        offset += bytesToCopy;
+        count -= bytesToCopy;
+        totalRead += bytesToCopy;
+    }
+
+    return totalRead;
+}
+
+int64_t CachedFileIO::seek(int64_t offset, int whence) noexcept
+{
+    if (!file)
+        return -1;
+
+    auto newOffset = offset;
+    switch (whence)
+    {
+    case RAUDIO2_SEEK_CUR:
+        newOffset += currentOffset;
+        break;
+    case RAUDIO2_SEEK_END:
+        newOffset += file->size();
+        break;
+    default:
+        break;
+    }
+
+    if (newOffset < 0)
+        return -1;
+
+    currentOffset = newOffset;
+    return 0;
+}
+
+int64_t CachedFileIO::tell() const noexcept
+{
+    if (!file)
+        return 0;
+
+    return currentOffset;
+}
+
+int64_t CachedFileIO::size() const noexcept
+{
+    if (!file)
+        return 0;
+
+    return file->size();
+}
+
+bool CachedFileIO::getIdentity(FileIdentity& identityOut) const noexcept
+{
+    if (!file)
+        return false;
+
+    return file->getIdentity(identityOut);
+}
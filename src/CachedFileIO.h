@@ -0,0 +1,38 @@
+#pragma once
+
+#include "BlockCache.h"
+#include "FileIO.h"
+#include <memory>
+
+// Read-only file IO going through the shared block cache
+class CachedFileIO : public VirtualIO
+{
+private:
+    std::unique_ptr<FileIO> file;
+    FileIdentity identity;
+    bool cacheable{};
+    int64_t currentOffset{ 0 };
+
+    std::shared_ptr<const BlockCache::Block> currentBlock; // Last block used, avoids a cache lookup per read
+    int64_t currentBlockIndex{ -1 };
+
+    std::shared_ptr<const BlockCache::Block> getBlock(int64_t blockIndex);
+
+public:
+    CachedFileIO(std::unique_ptr<FileIO>&& file_) noexcept;
+
+    CachedFileIO(CachedFileIO const&) = delete;
+    CachedFileIO& operator=(CachedFileIO const&) = delete;
+
+    int64_t read(void* ptr, int64_t count) noexcept override;
+
+    int64_t readAt(void* ptr, int64_t count, int64_t offset) noexcept override;
+
+    int64_t seek(int64_t offset, int whence) noexcept override;
+
+    int64_t tell() const noexcept override;
+
+    int64_t size() const noexcept override;
+
+    bool getIdentity(FileIdentity& identityOut) const noexcept override;
+};
@@ -1,71 +1,282 @@
 #include "FileIO.h"
+#include <algorithm>
+#include <cstring>
 #include "raudio2/raudio2_config.h"
 #include "Utils.h"
 
-FileIO::FileIO(const char* fileName, const char* mode) noexcept
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Largest amount of bytes passed to a single read/write call
+static constexpr int64_t MaxChunkSize = 1 << 30;
+
+FileIO::FileIO(const char* fileName, const char* mode, int64_t readAheadSize) noexcept
 {
-#ifdef RAUDIO2_SYSTEM_WINDOWS
-    _wfopen_s(&file, str2wstr(fileName).c_str(), str2wstr(mode).c_str());
+    if (fileName == nullptr || mode == nullptr)
+        return;
+
+    bool writing = std::strchr(mode, 'w') != nullptr;
+    bool update = std::strchr(mode, '+') != nullptr;
+    append = std::strchr(mode, 'a') != nullptr;
+
+#if defined(_WIN32)
+    DWORD access = writing || append || update ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ;
+    DWORD creation = writing ? CREATE_ALWAYS : (append ? OPEN_ALWAYS : OPEN_EXISTING);
+    DWORD flags = writing || append ? FILE_ATTRIBUTE_NORMAL : FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN;
+
+    auto fileHandle = CreateFileW(str2wstr(fileName).c_str(), access, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, creation, flags, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        return;
+
+    LARGE_INTEGER size{};
+    if (GetFileSizeEx(fileHandle, &size))
+        fileSize = (int64_t)size.QuadPart;
+
+    file = fileHandle;
 #else
-    file = fopen(fileName, mode);
+    int flags = writing ? O_CREAT | O_TRUNC : (append ? O_CREAT | O_APPEND : 0);
+    flags |= writing || append || update ? (update ? O_RDWR : O_WRONLY) : O_RDONLY;
+
+    file = open(fileName, flags, 0644);
+    if (file < 0)
+        return;
+
+    struct stat fileStat{};
+    if (fstat(file, &fileStat) == 0)
+        fileSize = (int64_t)fileStat.st_size;
+
+#if defined(POSIX_FADV_SEQUENTIAL)
+    if (!writing && !append)
+        posix_fadvise(file, 0, 0, POSIX_FADV_SEQUENTIAL);
 #endif
+#endif
+
+    if (!writing && !append && readAheadSize > 0)
+        buffer.resize((size_t)readAheadSize);
 }
 
 FileIO::~FileIO() noexcept
 {
-    if (!file)
+    if (!valid())
         return;
 
-    fclose(file);
+#if defined(_WIN32)
+    CloseHandle(file);
     file = nullptr;
+#else
+    close(file);
+    file = -1;
+#endif
+}
+
+int64_t FileIO::readFile(void* ptr, int64_t count, int64_t offset) const noexcept
+{
+    int64_t totalRead = 0;
+
+    while (totalRead < count)
+    {
+        auto chunkSize = std::min(count - totalRead, MaxChunkSize);
+        auto chunkPtr = (unsigned char*)ptr + totalRead;
+
+#if defined(_WIN32)
+        OVERLAPPED overlapped{};
+        overlapped.Offset = (DWORD)((offset + totalRead) & 0xFFFFFFFF);
+        overlapped.OffsetHigh = (DWORD)((offset + totalRead) >> 32);
+
+        DWORD bytesRead = 0;
+        if (!ReadFile(file, chunkPtr, (DWORD)chunkSize, &bytesRead, &overlapped) || bytesRead == 0)
+            break;
+#else
+        auto bytesRead = pread(file, chunkPtr, (size_t)chunkSize, (off_t)(offset + totalRead));
+        if (bytesRead < 0 && errno == EINTR)
+            continue;
+        if (bytesRead <= 0)
+            break;
+#endif
+        totalRead += (int64_t)bytesRead;
+    }
+
+    return totalRead;
+}
+
+int64_t FileIO::writeFile(const void* ptr, int64_t count, int64_t offset) noexcept
+{
+    int64_t totalWritten = 0;
+
+    while (totalWritten < count)
+    {
+        auto chunkSize = std::min(count - totalWritten, MaxChunkSize);
+        auto chunkPtr = (const unsigned char*)ptr + totalWritten;
+
+#if defined(_WIN32)
+        OVERLAPPED overlapped{};
+        overlapped.Offset = (DWORD)((offset + totalWritten) & 0xFFFFFFFF);
+        overlapped.OffsetHigh = (DWORD)((offset + totalWritten) >> 32);
+
+        DWORD bytesWritten = 0;
+        if (!WriteFile(file, chunkPtr, (DWORD)chunkSize, &bytesWritten, &overlapped) || bytesWritten == 0)
+            break;
+#else
+        auto bytesWritten = pwrite(file, chunkPtr, (size_t)chunkSize, (off_t)(offset + totalWritten));
+        if (bytesWritten < 0 && errno == EINTR)
+            continue;
+        if (bytesWritten <= 0)
+            break;
+#endif
+        totalWritten += (int64_t)bytesWritten;
+    }
+
+    return totalWritten;
 }
 
 int64_t FileIO::read(void* ptr, int64_t count) noexcept
 {
-    if (!file)
+    auto bytesRead = readAt(ptr, count, currentOffset);
+    currentOffset += bytesRead;
+    return bytesRead;
+}
+
+int64_t FileIO::readAt(void* ptr, int64_t count, int64_t offset) noexcept
+{
+    if (!valid() || count <= 0 || offset < 0)
         return 0;
 
-    return (int64_t)fread(ptr, 1, (size_t)count, file);
+    auto out = (unsigned char*)ptr;
+    int64_t totalRead = 0;
+
+    while (count > 0)
+    {
+        // Serve what we can from the read-ahead buffer
+        if (offset >= bufferOffset && offset < bufferOffset + bufferSize)
+        {
+            auto bytesToCopy = std::min(count, bufferOffset + bufferSize - offset);
+            std::memcpy(out, buffer.data() + (offset - bufferOffset), (size_t)bytesToCopy);
+            out += bytesToCopy;
+            offset += bytesToCopy;
+            count -= bytesToCopy;
+            totalRead += bytesToCopy;
+            continue;
+        }
+
+        // Large reads bypass the buffer
+        if (count >= (int64_t)buffer.size())
+        {
+            totalRead += readFile(out, count, offset);
+            break;
+        }
+
+        bufferOffset = offset;
+        bufferSize = readFile(buffer.data(), (int64_t)buffer.size(), offset);
+        if (bufferSize <= 0)
+        {
+            bufferSize = 0;
+            break;
+        }
+    }
+
+    return totalRead;
 }
 
 int64_t FileIO::write(void* ptr, int64_t count) noexcept
 {
-    if (!file)
+    if (!valid() || count <= 0)
         return 0;
 
-    return (int64_t)fwrite(ptr, 1, (size_t)count, file);
+    // Appending writes at the end of the file wherever the position is, like fopen
+    if (append)
+        currentOffset = fileSize;
+
+    auto bytesWritten = writeFile(ptr, count, currentOffset);
+
+    // Drop buffered data overlapping the written range
+    if (currentOffset < bufferOffset + bufferSize && currentOffset + bytesWritten > bufferOffset)
+        bufferSize = 0;
+
+    currentOffset += bytesWritten;
+    fileSize = std::max(fileSize, currentOffset);
+    return bytesWritten;
 }
 
 int64_t FileIO::seek(int64_t offset, int whence) noexcept
 {
-    if (!file)
+    if (!valid())
         return -1;
 
-    return fseek(file, (long)offset, whence);
+    auto newOffset = offset;
+    switch (whence)
+    {
+    case RAUDIO2_SEEK_CUR:
+        newOffset += currentOffset;
+        break;
+    case RAUDIO2_SEEK_END:
+        newOffset += fileSize;
+        break;
+    default:
+        break;
+    }
+
+    if (newOffset < 0)
+        return -1;
+
+    currentOffset = newOffset;
+    return 0;
 }
 
 int64_t FileIO::tell() const noexcept
 {
-    if (!file)
+    if (!valid())
         return 0;
 
-    return (int64_t)ftell(file);
+    return currentOffset;
 }
 
 int64_t FileIO::size() const noexcept
 {
-    if (!file)
+    if (!valid())
         return 0;
 
-    auto pos = ftell(file);
-    fseek(file, 0L, SEEK_END);
-    auto fileSize = (int64_t)ftell(file);
-    fseek(file, pos, SEEK_SET);
+    return fileSize;
+}
+
+bool FileIO::getIdentity(FileIdentity& identityOut) const noexcept
+{
+    if (!valid())
+        return false;
 
-    if (fileSize <= 0)
-        fileSize = 0;
+#if defined(_WIN32)
+    BY_HANDLE_FILE_INFORMATION info{};
+    if (!GetFileInformationByHandle(file, &info))
+        return false;
 
-    return fileSize;
+    identityOut.device = info.dwVolumeSerialNumber;
+    identityOut.index = ((uint64_t)info.nFileIndexHigh << 32) | info.nFileIndexLow;
+    identityOut.modifiedTime = ((int64_t)info.ftLastWriteTime.dwHighDateTime << 32) | info.ftLastWriteTime.dwLowDateTime;
+    identityOut.size = ((int64_t)info.nFileSizeHigh << 32) | info.nFileSizeLow;
+#else
+    struct stat fileStat{};
+    if (fstat(file, &fileStat) != 0)
+        return false;
+
+    identityOut.device = (uint64_t)fileStat.st_dev;
+    identityOut.index = (uint64_t)fileStat.st_ino;
+    // Nanoseconds, a file rewritten within the same second must not match its old blocks
+#if defined(__APPLE__)
+    identityOut.modifiedTime = (int64_t)fileStat.st_mtimespec.tv_sec * 1000000000 + (int64_t)fileStat.st_mtimespec.tv_nsec;
+    identityOut.changedTime = (int64_t)fileStat.st_ctimespec.tv_sec * 1000000000 + (int64_t)fileStat.st_ctimespec.tv_nsec;
+#else
+    identityOut.modifiedTime = (int64_t)fileStat.st_mtim.tv_sec * 1000000000 + (int64_t)fileStat.st_mtim.tv_nsec;
+    identityOut.changedTime = (int64_t)fileStat.st_ctim.tv_sec * 1000000000 + (int64_t)fileStat.st_ctim.tv_nsec;
+#endif
+    identityOut.size = (int64_t)fileStat.st_size;
+#endif
+    return true;
 }
 
 std::vector<unsigned char> FileIO::LoadData(const char* fileName)
@@ -74,14 +285,14 @@ std::vector<unsigned char> FileIO::LoadData(const char* fileName)
 
     if (fileName != nullptr)
     {
-        FileIO file(fileName, "rb");
+        FileIO file(fileName, "rb", 0);
         if (file.valid())
         {
             auto size = file.size();
             if (size > 0)
             {
                 data.resize(size);
-                file.read(data.data(), data.size());
+                data.resize(file.read(data.data(), data.size()));
             }
         }
     }
@@ -5,22 +5,49 @@
 #include <vector>
 #include "VirtualIO.h"
 
+#ifndef RAUDIO2_FILEIO_READ_AHEAD_SIZE
+#define RAUDIO2_FILEIO_READ_AHEAD_SIZE 65536 // Read-ahead buffer size of streamed files
+#endif
+
+// File IO using positional reads/writes (64 bit offsets)
+// NOTE: Small reads are served from a read-ahead buffer
 class FileIO : public VirtualIO
 {
 private:
-    FILE* file{ nullptr };
+#if defined(_WIN32)
+    void* file{ nullptr };
+#else
+    int file{ -1 };
+#endif
+    int64_t fileSize{ 0 };
+    int64_t currentOffset{ 0 };
+    bool append{ false }; // Opened with "a", writes go to the end of the file
+
+    std::vector<unsigned char> buffer; // Read-ahead buffer
+    int64_t bufferOffset{ 0 };         // File offset of the buffered data
+    int64_t bufferSize{ 0 };           // Size of the buffered data
+
+    int64_t readFile(void* ptr, int64_t count, int64_t offset) const noexcept;
+
+    int64_t writeFile(const void* ptr, int64_t count, int64_t offset) noexcept;
 
 public:
-    FileIO(const char* fileName, const char* mode) noexcept;
+    FileIO(const char* fileName, const char* mode, int64_t readAheadSize = RAUDIO2_FILEIO_READ_AHEAD_SIZE) noexcept;
     ~FileIO() noexcept override;
 
     FileIO(FileIO const&) = delete;
     FileIO& operator=(FileIO const&) = delete;
 
+#if defined(_WIN32)
     bool valid() const noexcept { return file != nullptr; }
+#else
+    bool valid() const noexcept { return file >= 0; }
+#endif
 
     int64_t read(void* ptr, int64_t count) noexcept override;
 
+    int64_t readAt(void* ptr, int64_t count, int64_t offset) noexcept override;
+
     int64_t write(void* ptr, int64_t count) noexcept;
 
     int64_t seek(int64_t offset, int whence) noexcept override;
@@ -29,6 +56,8 @@ public:
 
     int64_t size() const noexcept override;
 
+    bool getIdentity(FileIdentity& identityOut) const noexcept override;
+
     static std::vector<unsigned char> LoadData(const char* fileName);
 
     static bool SaveData(const char* fileName, void* data, int64_t bytesToWrite);
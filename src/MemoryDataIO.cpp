@@ -3,10 +3,32 @@
 
 MemoryDataIO::MemoryDataIO(const char* fileName) noexcept
 {
-    fileData = FileIO::LoadData(fileName);
+    if (fileName == nullptr)
+        return;
+
+    // Identify the file through the handle the data is read from
+    FileIO file(fileName, "rb", 0);
+    if (!file.valid())
+        return;
+
+    hasIdentity = file.getIdentity(identity);
+
+    auto size = file.size();
+    if (size > 0)
+    {
+        fileData.resize((size_t)size);
+        fileData.resize((size_t)file.read(fileData.data(), size));
+    }
+
     if (!fileData.empty())
     {
         data = fileData.data();
         dataSize = (int64_t)fileData.size();
     }
 }
+
+bool MemoryDataIO::getIdentity(FileIdentity& identityOut) const noexcept
+{
+    identityOut = identity;
+    return hasIdentity;
+}
@@ -8,7 +8,11 @@ class MemoryDataIO : public MemoryIO
 {
 private:
     std::vector<unsigned char> fileData;
+    FileIdentity identity; // File the data was loaded from
+    bool hasIdentity{};
 
 public:
     MemoryDataIO(const char* fileName) noexcept;
+
+    bool getIdentity(FileIdentity& identityOut) const noexcept override;
 };
@@ -1,4 +1,5 @@
 #include "MemoryIO.h"
+#include <algorithm>
 #include <cstring>
 
 int64_t MemoryIO::read(void* ptr, int64_t count) noexcept
@@ -18,6 +19,19 @@ int64_t MemoryIO::read(void* ptr, int64_t count) noexcept
     return newCount;
 }
 
+int64_t MemoryIO::readAt(void* ptr, int64_t count, int64_t offset) noexcept
+{
+    if (!data || offset < 0 || offset >= dataSize)
+        return 0;
+
+    int64_t newCount = std::min(count, dataSize - offset);
+
+    if (newCount > 0)
+        std::memcpy(ptr, data + offset, (size_t)newCount);
+
+    return newCount;
+}
+
 int64_t MemoryIO::seek(int64_t offset, int whence) noexcept
 {
     if (!data)
@@ -36,8 +50,11 @@ int64_t MemoryIO::seek(int64_t offset, int whence) noexcept
         break;
     }
 
+    if (newOffset < 0)
+        return -1;
+
     currentOffset = newOffset < dataSize ? newOffset : dataSize;
-    return currentOffset;
+    return 0;
 }
 
 int64_t MemoryIO::tell() const noexcept
@@ -22,9 +22,17 @@ public:
 
     int64_t read(void* ptr, int64_t count) noexcept override;
 
+    int64_t readAt(void* ptr, int64_t count, int64_t offset) noexcept override;
+
     int64_t seek(int64_t offset, int whence) noexcept override;
 
     int64_t tell() const noexcept override;
 
     int64_t size() const noexcept override;
+
+    const void* getBuffer(int64_t& sizeOut) const noexcept override
+    {
+        sizeOut = dataSize;
+        return data;
+    }
 };
@@ -0,0 +1,82 @@
+#include "MmapIO.h"
+#include "Utils.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MmapIO::MmapIO(const char* fileName) noexcept
+{
+    if (fileName == nullptr)
+        return;
+
+#if defined(_WIN32)
+    auto fileHandle = CreateFileW(str2wstr(fileName).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        return;
+
+    LARGE_INTEGER fileSize{};
+    if (GetFileSizeEx(fileHandle, &fileSize) && fileSize.QuadPart > 0)
+    {
+        mapping = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping != nullptr)
+        {
+            data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (data != nullptr)
+                dataSize = (int64_t)fileSize.QuadPart;
+            else
+            {
+                CloseHandle(mapping);
+                mapping = nullptr;
+            }
+        }
+    }
+
+    // The mapping keeps the file open
+    CloseHandle(fileHandle);
+#elif defined(__unix__) || defined(__APPLE__)
+    int fd = open(fileName, O_RDONLY);
+    if (fd < 0)
+        return;
+
+    struct stat fileStat{};
+    if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+    {
+        auto mapped = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapped != MAP_FAILED)
+        {
+            // Decoders mostly read forward, let the kernel read ahead aggressively
+            madvise(mapped, (size_t)fileStat.st_size, MADV_SEQUENTIAL);
+
+            data = (const unsigned char*)mapped;
+            dataSize = (int64_t)fileStat.st_size;
+        }
+    }
+
+    // The mapping keeps the file open
+    close(fd);
+#endif
+}
+
+MmapIO::~MmapIO() noexcept
+{
+    if (!data)
+        return;
+
+#if defined(_WIN32)
+    UnmapViewOfFile(data);
+    CloseHandle(mapping);
+    mapping = nullptr;
+#elif defined(__unix__) || defined(__APPLE__)
+    munmap((void*)data, (size_t)dataSize);
+#endif
+    data = nullptr;
+    dataSize = 0;
+}
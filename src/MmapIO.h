@@ -0,0 +1,21 @@
+#pragma once
+
+#include "MemoryIO.h"
+
+// Memory mapped file IO (read only)
+class MmapIO : public MemoryIO
+{
+private:
+#if defined(_WIN32)
+    void* mapping{ nullptr };
+#endif
+
+public:
+    MmapIO(const char* fileName) noexcept;
+    ~MmapIO() noexcept override;
+
+    MmapIO(MmapIO const&) = delete;
+    MmapIO& operator=(MmapIO const&) = delete;
+
+    bool valid() const noexcept { return data != nullptr; }
+};
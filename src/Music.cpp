@@ -1,100 +1,176 @@
 #include "Music.h"
+#include <algorithm>
+#include <array>
 #include "ArchivePluginIO.h"
 #include "AudioData.h"
 #include "AudioDevice.h"
+#include "CachedFileIO.h"
+#include <charconv>
 #include <cinttypes>
+#include <cstring>
 #include "FileIO.h"
 #include "MemoryDataIO.h"
+#include "MmapIO.h"
+#include "PrefetchIO.h"
 #include <string_view>
 #include "Utils.h"
+#include <vector>
 
-Music::Music()
+// Candidate input plugins for a file, sorted by score (highest first)
+// Scores add up: file extension match, signature match and the plugin's own probe
+static std::vector<ra::InputPlugin> GetInputPluginCandidates(const AudioDevice& audioDevice, const char* fileName, const void* header, int64_t headerSize)
 {
-    static int32_t musicIDCounter = 1;
-    ID = musicIDCounter++;
-}
+    constexpr int32_t extensionScore = 25;
+    constexpr int32_t signatureScore = 100;
+    constexpr int32_t maxProbeScore = 100;
 
-int32_t Music::Load(AudioDevice& audioDevice, const char* fileName, bool streamFile, VirtualIOWrapper&& file)
-{
-    auto music = std::make_unique<Music>();
-    bool musicLoaded = false;
+    std::vector<std::pair<int32_t, ra::InputPlugin>> scoredPlugins;
 
-    auto [filePath, subFilePath] = SplitStringIn2(fileName, '|');
+    auto extensionPlugins = audioDevice.InputPluginsByExtension(fileName);
 
-    if (!file)
+    for (const auto& pluginPtr : audioDevice.InputPlugins())
     {
-        file.setFile(std::make_unique<FileIO>(filePath.c_str(), "rb"));
+        ra::InputPlugin plugin(*pluginPtr);
+        int32_t score = 0;
 
-        for (const auto& plugintPtr : audioDevice.ArchivePlugins())
+        if (extensionPlugins && std::find(extensionPlugins->begin(), extensionPlugins->end(), pluginPtr.get()) != extensionPlugins->end())
+            score += extensionScore;
+
+        if (headerSize > 0)
         {
-            ra::ArchivePlugin plugin(*plugintPtr);
-            RAudio2_Archive tempArchive;
-            tempArchive.file = &file.GetVirtualIO();
-            void* tempFileCtx{};
+            if (MatchSignatures(plugin.getSignatures(), header, headerSize))
+                score += signatureScore;
 
-            file.seek(0, RAUDIO2_SEEK_SET);
+            if (plugin.hasValidProbe())
+                score += std::clamp(plugin.probe(header, headerSize), 0, maxProbeScore);
+        }
 
-            if (!plugin.archiveOpen(&tempArchive))
-                continue;
+        if (score > 0)
+            scoredPlugins.emplace_back(score, plugin);
+    }
 
-            if (!plugin.fileOpen(&tempArchive, subFilePath.c_str(), &tempFileCtx))
-                continue;
+    // Stable sort keeps the registration order for plugins with the same score
+    std::stable_sort(scoredPlugins.begin(), scoredPlugins.end(), [](const auto& a, const auto& b) {
+        return a.first > b.first;
+    });
 
-            music->archive = tempArchive;
-            music->archiveFileCtx = tempFileCtx;
-            music->archivePlugin = plugin;
+    std::vector<ra::InputPlugin> candidates;
+    candidates.reserve(scoredPlugins.size());
+    for (const auto& scoredPlugin : scoredPlugins)
+        candidates.push_back(scoredPlugin.second);
 
-            music->archiveFile = std::move(file);
-            file = VirtualIOWrapper(std::make_unique<ArchivePluginIO>(music->archivePlugin, tempFileCtx));
-            break;
-        }
+    return candidates;
+}
 
-        if (!music->archivePlugin)
-        {
-            if (streamFile)
-                file.seek(0, RAUDIO2_SEEK_SET);
-            else
-                file.setFile(std::make_unique<MemoryDataIO>(filePath.c_str()));
-        }
+// Flags that keep reading the file from disk
+static constexpr int32_t StreamLoadFlags = RAUDIO2_LOAD_FLAG_STREAM | RAUDIO2_LOAD_FLAG_PREFETCH | RAUDIO2_LOAD_FLAG_SHARED_CACHE;
+
+// Open a file for reading, layering the shared block cache and read-ahead thread as requested
+static std::unique_ptr<VirtualIO> OpenStreamFile(const char* filePath, int32_t loadFlags)
+{
+    // The layers above do their own buffering
+    bool layered = (loadFlags & (RAUDIO2_LOAD_FLAG_PREFETCH | RAUDIO2_LOAD_FLAG_SHARED_CACHE)) != 0;
+    auto fileIO = std::make_unique<FileIO>(filePath, "rb", layered ? 0 : RAUDIO2_FILEIO_READ_AHEAD_SIZE);
+
+    std::unique_ptr<VirtualIO> file;
+    if (loadFlags & RAUDIO2_LOAD_FLAG_SHARED_CACHE)
+        file = std::make_unique<CachedFileIO>(std::move(fileIO));
+    else
+        file = std::move(fileIO);
+
+    if (loadFlags & RAUDIO2_LOAD_FLAG_PREFETCH)
+        file = std::make_unique<PrefetchIO>(std::move(file));
+
+    return file;
+}
+
+// Splits a trailing "|track=N" selector off a file name into trackOut (0 without selector)
+// Returns false if the selector isn't a track number
+static bool SplitTrackSelector(std::string& fileName, int32_t& trackOut)
+{
+    constexpr std::string_view trackSelector = "|track=";
+
+    trackOut = 0;
+    auto pos = fileName.rfind(trackSelector);
+    if (pos == std::string::npos)
+        return true;
+
+    auto first = fileName.data() + pos + trackSelector.size();
+    auto last = fileName.data() + fileName.size();
+    auto [end, error] = std::from_chars(first, last, trackOut);
+    if (first == last || error != std::errc() || end != last || trackOut < 0)
+    {
+        RAUDIO2_TRACELOG(RAUDIO2_LOG_WARNING, "FILEIO: Invalid track selector: %s", fileName.c_str() + pos + 1);
+        trackOut = 0;
+        return false;
     }
 
+    fileName.resize(pos);
+    return true;
+}
+
+Music::Music()
+{
+    static int32_t musicIDCounter = 1;
+    ID = musicIDCounter++;
+}
+
+int32_t Music::Load(AudioDevice& audioDevice, std::unique_ptr<Music>&& music, const char* fileName, VirtualIOWrapper&& file, int32_t loadFlags)
+{
+    constexpr size_t ProbeHeaderSize = 4096;
+
+    bool musicLoaded = false;
+
     if (!file)
+    {
+        if (music->archive)
+            music->archive->CloseEntry(music->archiveFileCtx);
         return false;
+    }
 
-    if (!subFilePath.empty())
-        filePath = std::move(subFilePath);
+    // Read a small header shared by all plugin probes
+    std::array<unsigned char, ProbeHeaderSize> header{};
+    file.seek(0, RAUDIO2_SEEK_SET);
+    auto headerSize = std::max(file.read(header.data(), (int64_t)header.size()), (int64_t)0);
+    file.seek(0, RAUDIO2_SEEK_SET);
 
     music->file = std::move(file);
     music->waveInfo.file = &music->file.GetVirtualIO();
+    music->waveInfo.preferredSampleFormat = (int32_t)audioDevice.GetFormat();
+    music->waveInfo.preferredSampleRate = audioDevice.GetSampleRate();
+    music->waveInfo.preferredChannels = audioDevice.GetChannels();
+    music->waveInfo.loadFlags = loadFlags;
 
-    for (const auto& plugintPtr : audioDevice.InputPlugins())
-    {
-        ra::InputPlugin plugin(*plugintPtr);
+    auto candidates = GetInputPluginCandidates(audioDevice, fileName, header.data(), headerSize);
 
-        for (auto extPtr = plugin.getExtensions(); *extPtr; extPtr++)
+    int32_t musicID = {};
+
+    if (!candidates.empty())
+    {
+        for (const auto& plugin : candidates)
         {
-            if (IsFileExtension(filePath.c_str(), *extPtr))
+            music->file.seek(0, RAUDIO2_SEEK_SET);
+
+            if (plugin.open(&music->waveInfo))
             {
                 music->inputPlugin = plugin;
+                musicLoaded = true;
                 break;
             }
-        }
-
-        if (music->inputPlugin)
-            break;
-    }
 
-    int32_t musicID = {};
-
-    if (music->inputPlugin)
-    {
-        musicLoaded = music->inputPlugin.open(&music->waveInfo);
+            plugin.close(&music->waveInfo);
+            music->waveInfo.sampleFormat = {};
+            music->waveInfo.sampleRate = {};
+            music->waveInfo.channels = {};
+            music->waveInfo.frameCount = {};
+            music->waveInfo.ctxData = nullptr;
+        }
 
         if (!musicLoaded)
         {
-            music->inputPlugin.close(&music->waveInfo);
+            if (music->archive)
+                music->archive->CloseEntry(music->archiveFileCtx);
             music->waveInfo.file = nullptr;
-            music->waveInfo.ctxData = nullptr;
             music->file.setFile(nullptr);
             RAUDIO2_TRACELOG(RAUDIO2_LOG_WARNING, "FILEIO: Music file could not be opened");
         }
@@ -120,19 +196,90 @@ int32_t Music::Load(AudioDevice& audioDevice, const char* fileName, bool streamF
         }
     }
     else
+    {
+        if (music->archive)
+            music->archive->CloseEntry(music->archiveFileCtx);
         RAUDIO2_TRACELOG(RAUDIO2_LOG_WARNING, "STREAM: File format not supported");
+    }
 
     return musicID;
 }
 
-int32_t Music::Load(AudioDevice& audioDevice, const char* fileName, bool streamFile)
+int32_t Music::Load(AudioDevice& audioDevice, const char* fileName, int32_t loadFlags)
 {
-    return Load(audioDevice, fileName, streamFile, {});
+    auto music = std::make_unique<Music>();
+
+    std::string name(fileName);
+    if (!SplitTrackSelector(name, music->waveInfo.track))
+        return 0;
+
+    auto [filePath, subFilePath] = SplitStringIn2(name, '|');
+
+    VirtualIOWrapper file(OpenStreamFile(filePath.c_str(), loadFlags));
+
+    music->archive = MusicArchive::Open(audioDevice, filePath.c_str(), file, subFilePath.c_str(), &music->archiveFileCtx);
+    if (music->archive)
+    {
+        file = VirtualIOWrapper(std::make_unique<ArchivePluginIO>(music->archive->GetPlugin(), music->archiveFileCtx));
+    }
+    else if (loadFlags & RAUDIO2_LOAD_FLAG_MMAP)
+    {
+        // Share the page cache instead of keeping a private copy, keep streaming if mapping fails
+        auto mmapFile = std::make_unique<MmapIO>(filePath.c_str());
+        if (mmapFile->valid())
+            file.setFile(std::move(mmapFile));
+    }
+    else if (!(loadFlags & StreamLoadFlags))
+        file.setFile(std::make_unique<MemoryDataIO>(filePath.c_str()));
+
+    if (!subFilePath.empty())
+        filePath = std::move(subFilePath);
+
+    return Load(audioDevice, std::move(music), filePath.c_str(), std::move(file), loadFlags);
 }
 
 int32_t Music::LoadFromMemory(AudioDevice& audioDevice, const char* fileType, const unsigned char* dataIn, int64_t dataSize)
 {
-    return Load(audioDevice, fileType, false, VirtualIOWrapper(std::make_unique<MemoryIO>(dataIn, dataSize)));
+    return Load(audioDevice, std::make_unique<Music>(), fileType, VirtualIOWrapper(std::make_unique<MemoryIO>(dataIn, dataSize)), RAUDIO2_LOAD_FLAG_NONE);
+}
+
+int32_t Music::LoadFromArchive(AudioDevice& audioDevice, int32_t archiveId, const char* entryPath)
+{
+    auto archive = audioDevice.GetArchive(archiveId);
+    if (!archive)
+        return false;
+
+    auto music = std::make_unique<Music>();
+
+    std::string entryName(entryPath);
+    if (!SplitTrackSelector(entryName, music->waveInfo.track))
+        return false;
+
+    music->archiveFileCtx = archive->OpenEntry(entryName.c_str());
+    if (!music->archiveFileCtx)
+    {
+        RAUDIO2_TRACELOG(RAUDIO2_LOG_WARNING, "FILEIO: Archive entry could not be opened");
+        return false;
+    }
+
+    music->archive = std::move(archive);
+
+    VirtualIOWrapper file(std::make_unique<ArchivePluginIO>(music->archive->GetPlugin(), music->archiveFileCtx));
+    return Load(audioDevice, std::move(music), entryName.c_str(), std::move(file), RAUDIO2_LOAD_FLAG_NONE);
+}
+
+int32_t Music::OpenArchive(AudioDevice& audioDevice, const char* fileName, int32_t loadFlags)
+{
+    VirtualIOWrapper file(OpenStreamFile(fileName, loadFlags));
+
+    auto archive = MusicArchive::Open(audioDevice, fileName, file, nullptr, nullptr);
+    if (!archive)
+    {
+        RAUDIO2_TRACELOG(RAUDIO2_LOG_WARNING, "FILEIO: Archive file could not be opened");
+        return false;
+    }
+
+    return audioDevice.AddArchive(std::move(archive));
 }
 
 bool Music::IsReady()
@@ -148,10 +295,10 @@ void Music::Unload(AudioDevice& audioDevice)
 {
     stream->Unload(audioDevice);
     inputPlugin.close(&waveInfo);
-    if (archivePlugin)
+    if (archive)
     {
-        archivePlugin.fileClose(archiveFileCtx);
-        archivePlugin.archiveClose(&archive);
+        archive->CloseEntry(archiveFileCtx);
+        archive.reset();
     }
     audioDevice.DeleteMusic(ID);
 }
@@ -180,24 +327,43 @@ bool Music::IsStopped()
     return stream->IsStopped();
 }
 
-void Music::Update(AudioData& audioData)
+int64_t Music::ReadFrames(unsigned char* bufferOut, int64_t framesToRead)
 {
-    if (stream->buffer == nullptr)
-        return;
-
-    auto subBufferSizeInFrames = stream->buffer->sizeInFrames / 2;
+    if (!inputPlugin.hasValidReadBorrow())
+        return inputPlugin.read(&waveInfo, bufferOut, framesToRead);
 
-    // On first call of this function we lazily pre-allocated a temp buffer to read audio files/memory data in
-    auto frameSize = stream->GetChannels() * stream->GetSampleSize() / 8;
-    auto pcmSize = (int32_t)subBufferSizeInFrames * frameSize;
+    // Copy the frames lent by the decoder straight into the stream buffer
+    auto frameSize = (int64_t)stream->GetChannels() * stream->GetSampleSize() / 8;
+    int64_t framesRead = 0;
 
-    if (audioData.system.pcmBufferSize < pcmSize)
+    while (framesRead < framesToRead)
     {
-        RAUDIO2_FREE(audioData.system.pcmBuffer);
-        audioData.system.pcmBuffer = RAUDIO2_CALLOC(1, (size_t)pcmSize);
-        audioData.system.pcmBufferSize = pcmSize;
+        const void* framesIn{};
+        auto framesBorrowed = inputPlugin.readBorrow(&waveInfo, &framesIn, framesToRead - framesRead);
+
+        // The plugin can't lend frames for this file
+        if (framesBorrowed < 0)
+            return framesRead + inputPlugin.read(&waveInfo, bufferOut + framesRead * frameSize, framesToRead - framesRead);
+
+        if (framesBorrowed == 0 || framesIn == nullptr)
+            break;
+
+        framesBorrowed = std::min(framesBorrowed, framesToRead - framesRead);
+        std::memcpy(bufferOut + framesRead * frameSize, framesIn, (size_t)(framesBorrowed * frameSize));
+        framesRead += framesBorrowed;
     }
 
+    return framesRead;
+}
+
+void Music::Update()
+{
+    if (stream->buffer == nullptr)
+        return;
+
+    auto subBufferSizeInFrames = stream->buffer->sizeInFrames / 2;
+    auto frameSize = (int64_t)stream->GetChannels() * stream->GetSampleSize() / 8;
+
     // Check both sub-buffers to check if they require refilling
     for (int i = 0; i < 2; i++)
     {
@@ -212,12 +378,18 @@ void Music::Update(AudioData& audioData)
         else
             framesToStream = framesLeft;
 
+        // Decode straight into the stream sub-buffer
+        int32_t subBufferIndex = 0;
+        auto subBuffer = stream->BeginUpdate(subBufferIndex);
+        if (subBuffer == nullptr)
+            break;
+
         auto frameCountStillNeeded = framesToStream;
         int64_t frameCountReadTotal = 0;
 
         while (true)
         {
-            auto frameCountRead = (int64_t)inputPlugin.read(&waveInfo, (short*)((char*)audioData.system.pcmBuffer + frameCountReadTotal * frameSize), frameCountStillNeeded);
+            auto frameCountRead = ReadFrames(subBuffer + frameCountReadTotal * frameSize, frameCountStillNeeded);
             if (frameCountRead <= 0)
                 break;
 
@@ -229,7 +401,7 @@ void Music::Update(AudioData& audioData)
                 inputPlugin.seek(&waveInfo, 0);
         }
 
-        stream->Update(audioData.system.pcmBuffer, framesToStream);
+        stream->EndUpdate(subBufferIndex, framesToStream);
 
         stream->buffer->framesProcessed = stream->buffer->framesProcessed % frameCount;
 
@@ -321,7 +493,7 @@ bool Music::GetValue(const char* key, int32_t keyLength, RAudio2_Value* valueOut
 
 bool Music::GetArchiveValue(const char* key, int32_t keyLength, RAudio2_Value* valueOut) const noexcept
 {
-    if (archivePlugin)
-        return archivePlugin.getValue(archiveFileCtx, key, keyLength, valueOut);
+    if (archive)
+        return archive->GetPlugin().getValue(archiveFileCtx, key, keyLength, valueOut);
     return false;
 }
@@ -2,11 +2,10 @@
 
 #include "AudioStream.h"
 #include <memory>
-#include "raudio2/raudio2_archiveplugin.hpp"
+#include "MusicArchive.h"
 #include "raudio2/raudio2_inputplugin.hpp"
 #include "VirtualIO.h"
 
-struct AudioData;
 class AudioDevice;
 
 // Music, audio stream, anything longer than ~10 seconds should be streamed
@@ -19,15 +18,15 @@ private:
     bool looping{};                      // Music looping enable
 
     VirtualIOWrapper file;
-    VirtualIOWrapper archiveFile;
 
-    RAudio2_Archive archive;
+    std::shared_ptr<MusicArchive> archive; // Archive the music is loaded from, if any
     void* archiveFileCtx{};
     RAudio2_WaveInfo waveInfo;
-    ra::ArchivePlugin archivePlugin;
     ra::InputPlugin inputPlugin;
 
-    static int32_t Load(AudioDevice& audioDevice, const char* fileName, bool streamFile, VirtualIOWrapper&& file);
+    static int32_t Load(AudioDevice& audioDevice, std::unique_ptr<Music>&& music, const char* fileName, VirtualIOWrapper&& file, int32_t loadFlags);
+
+    int64_t ReadFrames(unsigned char* bufferOut, int64_t framesToRead);
 
 public:
     Music();
@@ -35,8 +34,11 @@ public:
     Music(Music const&) = delete;
     Music& operator=(Music const&) = delete;
 
-    static int32_t Load(AudioDevice& audioDevice, const char* fileName, bool streamFile);
+    static int32_t Load(AudioDevice& audioDevice, const char* fileName, int32_t loadFlags);
     static int32_t LoadFromMemory(AudioDevice& audioDevice, const char* fileType, const unsigned char* dataIn, int64_t dataSize);
+    static int32_t LoadFromArchive(AudioDevice& audioDevice, int32_t archiveId, const char* entryPath);
+
+    static int32_t OpenArchive(AudioDevice& audioDevice, const char* fileName, int32_t loadFlags);
 
     auto GetID() const noexcept { return ID; }
 
@@ -45,7 +47,7 @@ public:
     void Play();
     bool IsPlaying();
     bool IsStopped();
-    void Update(AudioData& audioData);
+    void Update();
     void Stop();
     void Pause();
     void Resume();
@@ -0,0 +1,104 @@
+#include "MusicArchive.h"
+#include <algorithm>
+#include <array>
+#include "AudioDevice.h"
+#include "Utils.h"
+
+// Archive plugins only run when their signatures or extensions match
+// Plugins without signatures are always tried
+static bool IsArchivePluginCandidate(const ra::ArchivePlugin& plugin, const char* fileName, const void* header, int64_t headerSize)
+{
+    auto signatures = plugin.getSignatures();
+    if (!signatures || MatchSignatures(signatures, header, headerSize))
+        return true;
+
+    auto extPtr = plugin.getExtensions();
+    if (!extPtr)
+        return false;
+
+    for (; *extPtr; extPtr++)
+    {
+        if (IsFileExtension(fileName, *extPtr))
+            return true;
+    }
+    return false;
+}
+
+MusicArchive::MusicArchive()
+{
+    static int32_t archiveIDCounter = 1;
+    ID = archiveIDCounter++;
+}
+
+MusicArchive::~MusicArchive()
+{
+    if (plugin)
+        plugin.archiveClose(&archive);
+}
+
+std::shared_ptr<MusicArchive> MusicArchive::Open(const AudioDevice& audioDevice, const char* filePath, VirtualIOWrapper& archiveFile, const char* entryPath, void** entryCtxOut)
+{
+    constexpr size_t ProbeHeaderSize = 4096;
+
+    if (!archiveFile)
+        return {};
+
+    std::array<unsigned char, ProbeHeaderSize> header{};
+    archiveFile.seek(0, RAUDIO2_SEEK_SET);
+    auto headerSize = std::max(archiveFile.read(header.data(), (int64_t)header.size()), (int64_t)0);
+
+    // Archive plugins keep pointers to the archive and its file, open them in place
+    auto musicArchive = std::make_shared<MusicArchive>();
+    musicArchive->file = std::move(archiveFile);
+
+    for (const auto& plugintPtr : audioDevice.ArchivePlugins())
+    {
+        ra::ArchivePlugin plugin(*plugintPtr);
+
+        if (!IsArchivePluginCandidate(plugin, filePath, header.data(), headerSize))
+            continue;
+
+        musicArchive->archive = {};
+        musicArchive->archive.file = &musicArchive->file.GetVirtualIO();
+        musicArchive->file.seek(0, RAUDIO2_SEEK_SET);
+
+        if (!plugin.archiveOpen(&musicArchive->archive))
+            continue;
+
+        if (entryPath)
+        {
+            void* entryCtx{};
+            if (!plugin.fileOpen(&musicArchive->archive, entryPath, &entryCtx))
+            {
+                plugin.archiveClose(&musicArchive->archive);
+                continue;
+            }
+            *entryCtxOut = entryCtx;
+        }
+
+        musicArchive->plugin = plugin;
+        return musicArchive;
+    }
+
+    // Not an archive, give the file back
+    archiveFile = std::move(musicArchive->file);
+    archiveFile.seek(0, RAUDIO2_SEEK_SET);
+    return {};
+}
+
+void* MusicArchive::OpenEntry(const char* entryPath)
+{
+    std::lock_guard lock(mutex);
+
+    void* entryCtx{};
+    if (!plugin.fileOpen(&archive, entryPath, &entryCtx))
+        return nullptr;
+    return entryCtx;
+}
+
+void MusicArchive::CloseEntry(void* entryCtx)
+{
+    std::lock_guard lock(mutex);
+
+    plugin.fileClose(entryCtx);
+}
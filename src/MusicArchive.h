@@ -0,0 +1,37 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include "raudio2/raudio2_archiveplugin.hpp"
+#include "VirtualIO.h"
+
+class AudioDevice;
+
+// Archive opened by an archive plugin, shared by every music loaded from it
+// NOTE: The archive is closed when it is closed by the user and the last music using it is unloaded
+class MusicArchive
+{
+private:
+    int32_t ID{};
+    VirtualIOWrapper file;
+    RAudio2_Archive archive;
+    ra::ArchivePlugin plugin;
+    std::mutex mutex; // Serializes entry open and close calls, entries can be loaded from any thread
+
+public:
+    MusicArchive();
+    ~MusicArchive();
+
+    MusicArchive(MusicArchive const&) = delete;
+    MusicArchive& operator=(MusicArchive const&) = delete;
+
+    // Find an archive plugin for the file, the file is kept by the archive only if a plugin opens it
+    // NOTE: If entryPath is set, the plugin must also open the entry (entryCtxOut receives the entry)
+    static std::shared_ptr<MusicArchive> Open(const AudioDevice& audioDevice, const char* filePath, VirtualIOWrapper& archiveFile, const char* entryPath, void** entryCtxOut);
+
+    auto GetID() const noexcept { return ID; }
+    auto& GetPlugin() const noexcept { return plugin; }
+
+    void* OpenEntry(const char* entryPath);
+    void CloseEntry(void* entryCtx);
+};
@@ -0,0 +1,212 @@
+#include "PrefetchIO.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+PrefetchIO::PrefetchIO(std::unique_ptr<VirtualIO>&& source_, int64_t blockSize_, int32_t blockCount)
+    : source(std::move(source_)), blockSize(std::max(blockSize_, (int64_t)4096))
+{
+    if (!source)
+        return;
+
+    sourceSize = source->size();
+
+    blocks.resize((size_t)std::max(blockCount, 2));
+    for (auto& block : blocks)
+        block.data.resize((size_t)blockSize);
+
+    ioThread = std::thread(&PrefetchIO::ioLoop, this);
+}
+
+PrefetchIO::~PrefetchIO() noexcept
+{
+    if (ioThread.joinable())
+    {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        ioCondition.notify_one();
+        ioThread.join();
+    }
+}
+
+PrefetchIO::Block* PrefetchIO::findBlock(int64_t index) noexcept
+{
+    for (auto& block : blocks)
+    {
+        if (block.index == index)
+            return &block;
+    }
+    return nullptr;
+}
+
+void PrefetchIO::ioLoop()
+{
+    auto blockCount = (int64_t)blocks.size();
+    auto sourceBlockCount = (sourceSize + blockSize - 1) / blockSize;
+
+    std::unique_lock lock(mutex);
+
+    while (!stopping)
+    {
+        // Find the first block of the window that isn't loaded yet
+        auto windowEnd = std::min(readBlockIndex + blockCount, sourceBlockCount);
+        int64_t missingIndex = -1;
+
+        for (auto index = readBlockIndex; index < windowEnd; index++)
+        {
+            if (!findBlock(index))
+            {
+                missingIndex = index;
+                break;
+            }
+        }
+
+        if (missingIndex < 0)
+        {
+            ioCondition.wait(lock);
+            continue;
+        }
+
+        // Reuse the block furthest away from the read position (at least one is outside the window)
+        Block* freeBlock = nullptr;
+        int64_t freeBlockDistance = -1;
+
+        for (auto& block : blocks)
+        {
+            if (block.index < 0)
+            {
+                freeBlock = &block;
+                break;
+            }
+            if (block.index >= readBlockIndex && block.index < windowEnd)
+                continue;
+
+            auto distance = std::abs(block.index - readBlockIndex);
+            if (distance > freeBlockDistance)
+            {
+                freeBlock = &block;
+                freeBlockDistance = distance;
+            }
+        }
+
+        if (!freeBlock)
+        {
+            ioCondition.wait(lock);
+            continue;
+        }
+
+        freeBlock->index = missingIndex;
+        freeBlock->size = 0;
+        freeBlock->ready = false;
+
+        // Read without holding the lock, readers only touch ready blocks
+        lock.unlock();
+        auto bytesRead = source->readAt(freeBlock->data.data(), blockSize, missingIndex * blockSize);
+        lock.lock();
+
+        freeBlock->size = std::max(bytesRead, (int64_t)0);
+        freeBlock->ready = true;
+        readCondition.notify_all();
+    }
+}
+
+int64_t PrefetchIO::read(void* ptr, int64_t count) noexcept
+{
+    auto bytesRead = readAt(ptr, count, currentOffset);
+    currentOffset += bytesRead;
+    return bytesRead;
+}
+
+int64_t PrefetchIO::readAt(void* ptr, int64_t count, int64_t offset) noexcept
+{
+    if (!source || count <= 0 || offset < 0)
+        return 0;
+
+    auto out = (unsigned char*)ptr;
+    int64_t totalRead = 0;
+
+    std::unique_lock lock(mutex);
+
+    while (count > 0 && offset < sourceSize)
+    {
+        auto index = offset / blockSize;
+        if (index != readBlockIndex)
+        {
+            readBlockIndex = index;
+            ioCondition.notify_one();
+        }
+
+        Block* block = nullptr;
+        readCondition.wait(lock, [&] {
+            block = findBlock(index);
+            return (block && block->ready) || stopping;
+        });
+
+        if (!block || !block->ready)
+            break;
+
+        auto blockOffset = offset - index * blockSize;
+        if (blockOffset >= block->size)
+            break;
+
+        auto bytesToCopy = std::min(count, block->size - blockOffset);
+        std::memcpy(out, block->data.data() + blockOffset, (size_t)bytesToCopy);
+        out += bytesToCopy;
+        offset += bytesToCopy;
+        count -= bytesToCopy;
+        totalRead += bytesToCopy;
+    }
+
+    return totalRead;
+}
+
+int64_t PrefetchIO::seek(int64_t offset, int whence) noexcept
+{
+    if (!source)
+        return -1;
+
+    auto newOffset = offset;
+    switch (whence)
+    {
+    case RAUDIO2_SEEK_CUR:
+        newOffset += currentOffset;
+        break;
+    case RAUDIO2_SEEK_END:
+        newOffset += sourceSize;
+        break;
+    default:
+        break;
+    }
+
+    if (newOffset < 0)
+        return -1;
+
+    currentOffset = newOffset;
+    return 0;
+}
+
+int64_t PrefetchIO::tell() const noexcept
+{
+    if (!source)
+        return 0;
+
+    return currentOffset;
+}
+
+int64_t PrefetchIO::size() const noexcept
+{
+    if (!source)
+        return 0;
+
+    return sourceSize;
+}
+
+bool PrefetchIO::getIdentity(FileIdentity& identityOut) const noexcept
+{
+    if (!source)
+        return false;
+
+    return source->getIdentity(identityOut);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "VirtualIO.h"
+
+#ifndef RAUDIO2_PREFETCH_BLOCK_SIZE
+#define RAUDIO2_PREFETCH_BLOCK_SIZE 65536 // Size of a prefetched block
+#endif
+#ifndef RAUDIO2_PREFETCH_BLOCK_COUNT
+#define RAUDIO2_PREFETCH_BLOCK_COUNT 16 // Number of blocks kept ahead of the read position
+#endif
+
+// Read-only IO that keeps blocks ahead of the read position filled by an IO thread
+// NOTE: The source is only accessed from the IO thread (using readAt)
+class PrefetchIO : public VirtualIO
+{
+private:
+    struct Block
+    {
+        int64_t index{ -1 }; // Block index in the source (-1 if unused)
+        int64_t size{ 0 };   // Bytes read
+        bool ready{};        // Data has been read
+        std::vector<unsigned char> data;
+    };
+
+    std::unique_ptr<VirtualIO> source;
+    int64_t sourceSize{ 0 };
+    int64_t blockSize{ 0 };
+    int64_t currentOffset{ 0 };
+
+    std::vector<Block> blocks;
+    int64_t readBlockIndex{ 0 }; // Block of the last read, start of the prefetch window
+    bool stopping{};
+
+    std::mutex mutex;
+    std::condition_variable ioCondition;   // Signals the IO thread
+    std::condition_variable readCondition; // Signals readers
+    std::thread ioThread;
+
+    void ioLoop();
+
+    Block* findBlock(int64_t index) noexcept;
+
+public:
+    PrefetchIO(std::unique_ptr<VirtualIO>&& source_,
+        int64_t blockSize_ = RAUDIO2_PREFETCH_BLOCK_SIZE,
+        int32_t blockCount = RAUDIO2_PREFETCH_BLOCK_COUNT);
+    ~PrefetchIO() noexcept override;
+
+    PrefetchIO(PrefetchIO const&) = delete;
+    PrefetchIO& operator=(PrefetchIO const&) = delete;
+
+    int64_t read(void* ptr, int64_t count) noexcept override;
+
+    int64_t readAt(void* ptr, int64_t count, int64_t offset) noexcept override;
+
+    int64_t seek(int64_t offset, int whence) noexcept override;
+
+    int64_t tell() const noexcept override;
+
+    int64_t size() const noexcept override;
+
+    bool getIdentity(FileIdentity& identityOut) const noexcept override;
+};
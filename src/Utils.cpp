@@ -35,6 +35,23 @@ const char* GetFileExtension(const char* fileName)
     return dot;
 }
 
+bool MatchSignatures(const RAudio2_Signature* signatures, const void* header, int64_t headerSize)
+{
+    if (!signatures || !header)
+        return false;
+
+    for (; signatures->size > 0; signatures++)
+    {
+        if (signatures->offset < 0 || (int64_t)signatures->offset + signatures->size > headerSize)
+            continue;
+
+        if (memcmp((const char*)header + signatures->offset, signatures->bytes, (size_t)signatures->size) == 0)
+            return true;
+    }
+
+    return false;
+}
+
 std::pair<std::string, std::string> SplitStringIn2(const std::string_view str, char delimiter)
 {
     auto pos = str.find(delimiter, 0);
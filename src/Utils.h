@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include "raudio2/raudio2_signature.h"
 #include <string>
 #include <string_view>
 #include <utility>
@@ -10,6 +12,9 @@ bool IsFileExtension(const char* fileName, const char* ext);
 // Get pointer to extension for a filename string (includes the dot: .png)
 const char* GetFileExtension(const char* fileName);
 
+// Check if any signature of a list matches the header bytes of a file
+bool MatchSignatures(const RAudio2_Signature* signatures, const void* header, int64_t headerSize);
+
 std::pair<std::string, std::string> SplitStringIn2(const std::string_view str, char delimiter);
 
 void* LoadExternalLibrary(const char* filePath);
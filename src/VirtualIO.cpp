@@ -36,6 +36,45 @@ static int64_t VirtualIO_Size(void* handle)
     return file->size();
 }
 
+static const void* VirtualIO_GetBuffer(void* handle, int64_t* sizeOut)
+{
+    *sizeOut = 0;
+
+    auto file = (VirtualIO*)handle;
+    if (!file)
+        return nullptr;
+
+    return file->getBuffer(*sizeOut);
+}
+
+static int32_t VirtualIO_GetIdentity(void* handle, RAudio2_FileIdentity* identityOut)
+{
+    *identityOut = {};
+
+    auto file = (VirtualIO*)handle;
+    FileIdentity identity;
+    if (!file || !file->getIdentity(identity))
+        return 0;
+
+    identityOut->device = identity.device;
+    identityOut->index = identity.index;
+    identityOut->modifiedTime = identity.modifiedTime;
+    identityOut->changedTime = identity.changedTime;
+    identityOut->size = identity.size;
+    return 1;
+}
+
+int64_t VirtualIO::readAt(void* buffer, int64_t count, int64_t offset)
+{
+    auto position = tell();
+    if (seek(offset, RAUDIO2_SEEK_SET) != 0)
+        return 0;
+
+    auto bytesRead = read(buffer, count);
+    seek(position, RAUDIO2_SEEK_SET);
+    return bytesRead;
+}
+
 VirtualIOWrapper::VirtualIOWrapper()
 {
     virtualIO.handle = nullptr;
@@ -44,6 +83,8 @@ VirtualIOWrapper::VirtualIOWrapper()
     virtualIO.seek = VirtualIO_Seek;
     virtualIO.tell = VirtualIO_Tell;
     virtualIO.getSize = VirtualIO_Size;
+    virtualIO.getBuffer = VirtualIO_GetBuffer;
+    virtualIO.getIdentity = VirtualIO_GetIdentity;
 }
 
 VirtualIOWrapper::VirtualIOWrapper(std::unique_ptr<VirtualIO>&& file_) : VirtualIOWrapper()
@@ -79,3 +120,8 @@ int64_t VirtualIOWrapper::size() const noexcept
 {
     return virtualIO.getSize(virtualIO.handle);
 }
+
+const void* VirtualIOWrapper::getBuffer(int64_t& sizeOut) const noexcept
+{
+    return virtualIO.getBuffer(virtualIO.handle, &sizeOut);
+}
@@ -4,6 +4,18 @@
 #include <memory>
 #include "raudio2/raudio2_inputplugin.hpp"
 
+// Identifies a file on disk, changes when the file is modified
+struct FileIdentity
+{
+    uint64_t device{};
+    uint64_t index{};
+    int64_t modifiedTime{};
+    int64_t changedTime{}; // Inode change time, unused on Windows
+    int64_t size{};
+
+    bool operator==(const FileIdentity&) const = default;
+};
+
 class VirtualIO
 {
 public:
@@ -11,11 +23,28 @@ public:
 
     virtual int64_t read(void* buffer, int64_t count) = 0;
 
+    // Read at an absolute offset without moving the current position
+    virtual int64_t readAt(void* buffer, int64_t count, int64_t offset);
+
     virtual int64_t seek(int64_t offset, int whence) = 0;
 
     virtual int64_t tell() const = 0;
 
     virtual int64_t size() const = 0;
+
+    // Contiguous data of the whole file, nullptr if the file isn't backed by memory
+    virtual const void* getBuffer(int64_t& sizeOut) const
+    {
+        sizeOut = 0;
+        return nullptr;
+    }
+
+    // Identity of the file on disk, false if the file isn't a file on disk
+    virtual bool getIdentity(FileIdentity& identityOut) const
+    {
+        identityOut = {};
+        return false;
+    }
 };
 
 class VirtualIOWrapper
@@ -42,4 +71,6 @@ public:
     int64_t tell() const noexcept;
 
     int64_t size() const noexcept;
+
+    const void* getBuffer(int64_t& sizeOut) const noexcept;
 };
@@ -128,7 +128,16 @@ int32_t RAudio2_LoadMusic(RAUDIO2_HANDLE handle, const char* fileName, bool stre
     if (!audioDevice)
         return {};
 
-    return Music::Load(*audioDevice, fileName, streamFile);
+    return Music::Load(*audioDevice, fileName, streamFile ? RAUDIO2_LOAD_FLAG_STREAM : RAUDIO2_LOAD_FLAG_NONE);
+}
+
+int32_t RAudio2_LoadMusicEx(RAUDIO2_HANDLE handle, const char* fileName, int32_t loadFlags)
+{
+    auto audioDevice = (AudioDevice*)handle;
+    if (!audioDevice)
+        return {};
+
+    return Music::Load(*audioDevice, fileName, loadFlags);
 }
 
 int32_t RAudio2_LoadMusicFromMemory(RAUDIO2_HANDLE handle, const char* fileType, const unsigned char* dataIn, int64_t dataSize)
@@ -140,6 +149,33 @@ int32_t RAudio2_LoadMusicFromMemory(RAUDIO2_HANDLE handle, const char* fileType,
     return Music::LoadFromMemory(*audioDevice, fileType, dataIn, dataSize);
 }
 
+int32_t RAudio2_OpenArchive(RAUDIO2_HANDLE handle, const char* fileName, int32_t loadFlags)
+{
+    auto audioDevice = (AudioDevice*)handle;
+    if (!audioDevice)
+        return {};
+
+    return Music::OpenArchive(*audioDevice, fileName, loadFlags);
+}
+
+int32_t RAudio2_LoadMusicFromArchive(RAUDIO2_HANDLE handle, int32_t archiveId, const char* entryName)
+{
+    auto audioDevice = (AudioDevice*)handle;
+    if (!audioDevice)
+        return {};
+
+    return Music::LoadFromArchive(*audioDevice, archiveId, entryName);
+}
+
+void RAudio2_CloseArchive(RAUDIO2_HANDLE handle, int32_t archiveId)
+{
+    auto audioDevice = (AudioDevice*)handle;
+    if (!audioDevice)
+        return;
+
+    audioDevice->DeleteArchive(archiveId);
+}
+
 bool RAudio2_IsMusicReady(RAUDIO2_HANDLE handle, int32_t musicId)
 {
     auto audioDevice = (AudioDevice*)handle;
@@ -226,7 +262,7 @@ void RAudio2_UpdateMusic(RAUDIO2_HANDLE handle, int32_t musicId)
 
     auto music = audioDevice->GetMusic(musicId);
     if (music)
-        music->Update(audioDevice->GetAudioData());
+        music->Update();
 }
 
 bool RAudio2_IsMusicPlaying(RAUDIO2_HANDLE handle, int32_t musicId)
@@ -17,6 +17,7 @@ vcpkg_check_features(OUT_FEATURE_OPTIONS FEATURE_OPTIONS
         mpg123     RAUDIO2_INPUT_MPG123
         openmpt    RAUDIO2_INPUT_OPENMPT
         opus       RAUDIO2_INPUT_OPUS
+        qoa        RAUDIO2_INPUT_QOA
         sndfile    RAUDIO2_INPUT_SNDFILE
         stbvorbis  RAUDIO2_INPUT_STBVORBIS
         vorbis     RAUDIO2_INPUT_VORBIS